@@ -0,0 +1,177 @@
+#include "bimap.h"
+#include "btree_bimap.h"
+#include "concurrent_bimap.h"
+#include "unordered_bimap.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <shared_mutex>
+#include <vector>
+
+namespace {
+constexpr std::int64_t min_size = std::int64_t(1) << 10;
+// Every treap node is a separate allocation that misses the cache, larger sizes are measured for the B-tree only.
+constexpr std::int64_t treap_max_size = std::int64_t(1) << 20;
+constexpr std::int64_t max_size = std::int64_t(1) << 22;
+constexpr std::size_t queries = 1 << 12;
+constexpr std::size_t shared_size = 1 << 16;
+
+std::vector<int> shuffled_keys(std::size_t size, unsigned seed) {
+  std::vector<int> keys(size);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(seed));
+  return keys;
+}
+
+template <typename Bimap>
+Bimap make_bimap(std::size_t size) {
+  std::vector<int> lefts = shuffled_keys(size, 1);
+  std::vector<int> rights = shuffled_keys(size, 2);
+  Bimap b;
+  for (std::size_t i = 0; i < size; ++i) {
+    b.insert(lefts[i], rights[i]);
+  }
+  return b;
+}
+
+template <typename Bimap>
+void insert_random(benchmark::State& state) {
+  std::size_t size = static_cast<std::size_t>(state.range(0));
+  std::vector<int> lefts = shuffled_keys(size, 1);
+  std::vector<int> rights = shuffled_keys(size, 2);
+  for (auto _ : state) {
+    Bimap b;
+    for (std::size_t i = 0; i < size; ++i) {
+      b.insert(lefts[i], rights[i]);
+    }
+    benchmark::DoNotOptimize(b.size());
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+template <typename Bimap>
+void copy(benchmark::State& state) {
+  std::size_t size = static_cast<std::size_t>(state.range(0));
+  const Bimap b = make_bimap<Bimap>(size);
+  for (auto _ : state) {
+    Bimap copy = b;
+    benchmark::DoNotOptimize(copy.size());
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+template <typename Bimap>
+void find_left(benchmark::State& state) {
+  std::size_t size = static_cast<std::size_t>(state.range(0));
+  const Bimap b = make_bimap<Bimap>(size);
+  std::vector<int> keys = shuffled_keys(size, 3);
+  keys.resize(std::min(size, queries));
+  for (auto _ : state) {
+    for (int key : keys) {
+      benchmark::DoNotOptimize(*b.find_left(key).flip());
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+}
+
+template <typename Bimap>
+void find_right(benchmark::State& state) {
+  std::size_t size = static_cast<std::size_t>(state.range(0));
+  const Bimap b = make_bimap<Bimap>(size);
+  std::vector<int> keys = shuffled_keys(size, 3);
+  keys.resize(std::min(size, queries));
+  for (auto _ : state) {
+    for (int key : keys) {
+      benchmark::DoNotOptimize(b.at_right(key));
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+}
+
+template <typename Bimap>
+void lower_bound_left(benchmark::State& state) {
+  std::size_t size = static_cast<std::size_t>(state.range(0));
+  const Bimap b = make_bimap<Bimap>(size);
+  std::mt19937 rng(4);
+  std::vector<int> keys(std::min(size, queries));
+  std::generate(keys.begin(), keys.end(), [&] { return static_cast<int>(rng() % size); });
+  for (auto _ : state) {
+    for (int key : keys) {
+      benchmark::DoNotOptimize(*b.lower_bound_left(key));
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+}
+
+template <typename Bimap>
+void iterate_left(benchmark::State& state) {
+  std::size_t size = static_cast<std::size_t>(state.range(0));
+  const Bimap b = make_bimap<Bimap>(size);
+  for (auto _ : state) {
+    long long sum = 0;
+    for (auto it = b.begin_left(); it != b.end_left(); ++it) {
+      sum += *it.flip();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+// Every lookup takes its own shared lock or snapshot, as a request handler would. The tables are
+// shared by all the benchmark threads.
+void locked_find_left(benchmark::State& state) {
+  static const bimap<int, int> b = make_bimap<bimap<int, int>>(shared_size);
+  static std::shared_mutex mutex;
+  std::vector<int> keys = shuffled_keys(shared_size, 3 + static_cast<unsigned>(state.thread_index()));
+  keys.resize(queries);
+  for (auto _ : state) {
+    for (int key : keys) {
+      std::shared_lock lock(mutex);
+      benchmark::DoNotOptimize(*b.find_left(key).flip());
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+}
+
+void snapshot_find_left(benchmark::State& state) {
+  static const concurrent_bimap<int, int> b(make_bimap<bimap<int, int>>(shared_size));
+  std::vector<int> keys = shuffled_keys(shared_size, 3 + static_cast<unsigned>(state.thread_index()));
+  keys.resize(queries);
+  for (auto _ : state) {
+    for (int key : keys) {
+      auto snapshot = b.read();
+      benchmark::DoNotOptimize(*snapshot->find_left(key).flip());
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+}
+
+using treap = bimap<int, int>;
+using btree = btree_bimap<int, int>;
+using hashed = unordered_bimap<int, int>;
+} // namespace
+
+BENCHMARK_TEMPLATE(insert_random, treap)->RangeMultiplier(4)->Range(min_size, treap_max_size);
+BENCHMARK_TEMPLATE(insert_random, btree)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(insert_random, hashed)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(copy, treap)->RangeMultiplier(4)->Range(min_size, treap_max_size);
+BENCHMARK_TEMPLATE(copy, btree)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(copy, hashed)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(find_left, treap)->RangeMultiplier(4)->Range(min_size, treap_max_size);
+BENCHMARK_TEMPLATE(find_left, btree)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(find_left, hashed)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(find_right, treap)->RangeMultiplier(4)->Range(min_size, treap_max_size);
+BENCHMARK_TEMPLATE(find_right, btree)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(find_right, hashed)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(lower_bound_left, treap)->RangeMultiplier(4)->Range(min_size, treap_max_size);
+BENCHMARK_TEMPLATE(lower_bound_left, btree)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(iterate_left, treap)->RangeMultiplier(4)->Range(min_size, treap_max_size);
+BENCHMARK_TEMPLATE(iterate_left, btree)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(iterate_left, hashed)->RangeMultiplier(4)->Range(min_size, max_size);
+BENCHMARK(locked_find_left)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(snapshot_find_left)->ThreadRange(1, 16)->UseRealTime();
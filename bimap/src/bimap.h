@@ -1,18 +1,23 @@
 #pragma once
 
 #include "map.h"
+#include "node_pool.h"
 
 #include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 template <
     typename Left,
     typename Right,
     typename CompareLeft = std::less<Left>,
-    typename CompareRight = std::less<Right>>
+    typename CompareRight = std::less<Right>,
+    typename Allocator = std::allocator<std::pair<Left, Right>>>
 class bimap
     : private bimap_impl::map<bimap_impl::left_tag, Left, Right, CompareLeft>
     , private bimap_impl::map<bimap_impl::right_tag, Right, Left, CompareRight> {
@@ -26,30 +31,125 @@ public:
   using node_t = bimap_impl::bimap_node<left_t, right_t>;
   using left_map = bimap_impl::map<bimap_impl::left_tag, Left, Right, CompareLeft>;
   using right_map = bimap_impl::map<bimap_impl::right_tag, Right, Left, CompareRight>;
+  using allocator_type = Allocator;
+
+private:
+  using pool_t = bimap_impl::node_pool<node_t, Allocator>;
+
+public:
+  // Owns a pair taken out by extract(). The pair stays in its node, and the handle shares the slabs
+  // of the bimap it came from, so it doesn't depend on what happens to that bimap afterwards.
+  class node_type {
+  public:
+    node_type() noexcept = default;
+
+    node_type(node_type&& other) noexcept
+        : node_(std::exchange(other.node_, nullptr))
+        , slabs_(std::move(other.slabs_)) {}
+
+    node_type& operator=(node_type&& other) noexcept {
+      if (this != &other) {
+        reset();
+        node_ = std::exchange(other.node_, nullptr);
+        slabs_ = std::move(other.slabs_);
+      }
+      return *this;
+    }
+
+    ~node_type() {
+      reset();
+    }
+
+    bool empty() const noexcept {
+      return node_ == nullptr;
+    }
+
+    explicit operator bool() const noexcept {
+      return !empty();
+    }
+
+    // The keys may be changed while the pair is out of the bimap.
+    left_t& left() const noexcept {
+      return node_->left;
+    }
+
+    right_t& right() const noexcept {
+      return node_->right;
+    }
+
+  private:
+    friend class bimap;
+
+    node_type(node_t* node, typename pool_t::shared_slabs slabs) noexcept
+        : node_(node)
+        , slabs_(std::move(slabs)) {}
+
+    // The slot of a dropped pair is given back with the rest of its slab.
+    void reset() noexcept {
+      if (node_) {
+        std::destroy_at(std::exchange(node_, nullptr));
+      }
+      slabs_.reset();
+    }
+
+    node_t* node_ = nullptr;
+    typename pool_t::shared_slabs slabs_;
+  };
 
 public:
-  bimap(CompareLeft compare_left = CompareLeft(), CompareRight compare_right = CompareRight())
+  // Nodes are allocated from a pool of slabs taken from the allocator, see node_pool.
+  bimap(
+      CompareLeft compare_left = CompareLeft(),
+      CompareRight compare_right = CompareRight(),
+      const Allocator& allocator = Allocator()
+  )
       : left_map(std::move(compare_left))
-      , right_map(std::move(compare_right)) {}
+      , right_map(std::move(compare_right))
+      , pool_(allocator) {}
+
+  // Builds the bimap from a range of pairs. If the left keys come sorted, the left side is linked
+  // in linear time and the right side after a sort, an unsorted range is sorted first. Like insert(),
+  // only one of the pairs sharing a key is kept, which one is unspecified.
+  template <std::input_iterator InputIt>
+  bimap(
+      InputIt first,
+      InputIt last,
+      CompareLeft compare_left = CompareLeft(),
+      CompareRight compare_right = CompareRight(),
+      const Allocator& allocator = Allocator()
+  )
+      : bimap(std::move(compare_left), std::move(compare_right), allocator) {
+    std::vector<node_holder> nodes;
+    for (; first != last; ++first) {
+      auto&& element = *first;
+      nodes.push_back(make_node(
+          std::forward<decltype(element)>(element).first,
+          std::forward<decltype(element)>(element).second
+      ));
+    }
+    build(nodes);
+  }
 
   bimap(const bimap& other)
-      : left_map(static_cast<const left_map&>(other).compare)
-      , right_map(static_cast<const right_map&>(other).compare) {
-    try {
-      for (left_iterator it = other.begin_left(); it != other.end_left(); it++) {
-        insert(*it, *it.flip());
-      }
-    } catch (...) {
-      erase_left(begin_left(), end_left());
-      throw;
+      : bimap(
+            other.compare_left(),
+            other.compare_right(),
+            std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator())
+        ) {
+    std::vector<node_holder> nodes;
+    nodes.reserve(other.size());
+    for (left_iterator it = other.begin_left(); it != other.end_left(); it++) {
+      nodes.push_back(make_node(*it, *it.flip()));
     }
+    build(nodes);
   }
 
   bimap(bimap&& other) noexcept
       : left_map(std::move(static_cast<left_map&>(other).compare))
       , right_map(std::move(static_cast<right_map&>(other).compare))
       , size_(other.size_)
-      , base(std::move(other.base)) {
+      , base(std::move(other.base))
+      , pool_(std::move(other.pool_)) {
     other.size_ = 0;
   }
 
@@ -68,8 +168,22 @@ public:
     return *this;
   }
 
+  // The nodes are destroyed without unlinking them, and their slabs are released with the last
+  // bimap or handle sharing them.
   ~bimap() {
-    erase_left(begin_left(), end_left());
+    if constexpr (!std::is_trivially_destructible_v<node_t>) {
+      destroy_subtree(left().left);
+    }
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return pool_.get_allocator();
+  }
+
+  // Replaces the contents with the pairs of the range, the same way the range constructor builds them.
+  template <std::input_iterator InputIt>
+  void assign(InputIt first, InputIt last) {
+    *this = bimap(first, last, compare_left(), compare_right(), get_allocator());
   }
 
   friend void swap(bimap& lhs, bimap& rhs) noexcept {
@@ -79,6 +193,7 @@ public:
     swap(lhs.right(), rhs.right());
     swap(static_cast<left_map&>(lhs), static_cast<left_map&>(rhs));
     swap(static_cast<right_map&>(lhs), static_cast<right_map&>(rhs));
+    swap(lhs.pool_, rhs.pool_);
   }
 
   left_iterator insert(const left_t& left, const right_t& right) {
@@ -97,118 +212,282 @@ public:
     return insert_impl(std::move(left), std::move(right));
   }
 
+  // Inserts the pair right before the hints if it belongs there, which takes two comparisons per side,
+  // otherwise the hints are ignored. Passing the ends to insert sorted pairs takes amortized O(1) rotations.
+  left_iterator insert(left_iterator hint_left, right_iterator hint_right, const left_t& left, const right_t& right) {
+    return insert_impl(hint_left, hint_right, left, right);
+  }
+
+  left_iterator insert(left_iterator hint_left, right_iterator hint_right, const left_t& left, right_t&& right) {
+    return insert_impl(hint_left, hint_right, left, std::move(right));
+  }
+
+  left_iterator insert(left_iterator hint_left, right_iterator hint_right, left_t&& left, const right_t& right) {
+    return insert_impl(hint_left, hint_right, std::move(left), right);
+  }
+
+  left_iterator insert(left_iterator hint_left, right_iterator hint_right, left_t&& left, right_t&& right) {
+    return insert_impl(hint_left, hint_right, std::move(left), std::move(right));
+  }
+
   left_iterator erase_left(left_iterator it) {
-    left_iterator ans = this->left_map::erase(it);
-    size_--;
-    return ans;
+    left_iterator next = left_map::unlink(it);
+    free_node(it.get_node());
+    return next;
   }
 
   right_iterator erase_right(right_iterator it) {
-    right_iterator ans = this->right_map::erase(it);
-    size_--;
-    return ans;
+    right_iterator next = right_map::unlink(it);
+    free_node(it.flip().get_node());
+    return next;
   }
 
   bool erase_left(const left_t& value) {
-    if (this->left_map::erase(value, &left())) {
-      size_--;
-      return true;
-    }
-    return false;
+    return erase_left_impl(value);
+  }
+
+  // The overloads taking any key type are available for transparent comparators, so that a key
+  // comparable with the stored ones doesn't have to be converted first.
+  template <typename K>
+  bool erase_left(const K& value)
+    requires (bimap_impl::transparent<CompareLeft>)
+  {
+    return erase_left_impl(value);
   }
 
   bool erase_right(const right_t& value) {
-    if (this->right_map::erase(value, &right())) {
-      size_--;
-      return true;
-    }
-    return false;
+    return erase_right_impl(value);
+  }
+
+  template <typename K>
+  bool erase_right(const K& value)
+    requires (bimap_impl::transparent<CompareRight>)
+  {
+    return erase_right_impl(value);
   }
 
   left_iterator erase_left(left_iterator first, left_iterator last) {
-    size_t count = std::distance(first, last);
-    left_iterator ans = this->left_map::erase(first, last);
-    size_ -= count;
-    return ans;
+    while (first != last) {
+      first = erase_left(first);
+    }
+    return last;
   }
 
   right_iterator erase_right(right_iterator first, right_iterator last) {
-    size_t count = std::distance(first, last);
-    right_iterator ans = this->right_map::erase(first, last);
-    size_ -= count;
-    return ans;
+    while (first != last) {
+      first = erase_right(first);
+    }
+    return last;
+  }
+
+  // Unlinks the pair without destroying it.
+  node_type extract(left_iterator it) noexcept {
+    left_map::unlink(it);
+    size_--;
+    return node_type(static_cast<node_t*>(it.get_node()), pool_.share());
+  }
+
+  node_type extract(right_iterator it) noexcept {
+    return extract(it.flip());
+  }
+
+  // Inserts the pair of the handle and empties it. If the handle comes from a bimap with an equal
+  // allocator, its node is relinked, otherwise the pair is moved into a new node. If a key is taken,
+  // the handle keeps the pair.
+  left_iterator insert(node_type&& handle) {
+    if (handle.empty()) {
+      return end_left();
+    }
+    auto left_position = this->left_map::locate(handle.left(), &left());
+    if (left_position.found) {
+      return end_left();
+    }
+    auto right_position = this->right_map::locate(handle.right(), &right());
+    if (right_position.found) {
+      return end_left();
+    }
+    if (pool_.adopt(handle.slabs_)) {
+      auto* node = std::exchange(handle.node_, nullptr);
+      handle.reset();
+      return insert_node(left_position, right_position, node);
+    }
+    auto* new_node = pool_.create(std::move_if_noexcept(handle.left()), std::move_if_noexcept(handle.right()));
+    handle.reset();
+    return insert_node(left_position, right_position, new_node);
+  }
+
+  // Moves the pairs of `source` whose keys are both free in this bimap, the others stay in `source`.
+  // Each pair takes one descent per side. If the allocators are equal, the nodes are relinked and this
+  // bimap shares the slabs of `source`, otherwise the values are moved into new nodes.
+  void merge(bimap& source) {
+    if (&source == this || source.empty()) {
+      return;
+    }
+    bool relink = pool_.adopt(source.pool_.share());
+    for (left_iterator it = source.begin_left(); it != source.end_left();) {
+      auto left_position = this->left_map::locate(*it, &left());
+      if (left_position.found) {
+        ++it;
+        continue;
+      }
+      auto right_position = this->right_map::locate(*it.flip(), &right());
+      if (right_position.found) {
+        ++it;
+        continue;
+      }
+      auto* node = static_cast<node_t*>(it.get_node());
+      if (relink) {
+        it = source.left_map::unlink(it);
+        source.size_--;
+        insert_node(left_position, right_position, node);
+        continue;
+      }
+      auto* new_node = pool_.create(std::move_if_noexcept(node->left), std::move_if_noexcept(node->right));
+      it = source.erase_left(it);
+      insert_node(left_position, right_position, new_node);
+    }
+  }
+
+  void merge(bimap&& source) {
+    merge(source);
   }
 
   left_iterator find_left(const left_t& value) const {
     return this->left_map::find(value, &left());
   }
 
+  template <typename K>
+  left_iterator find_left(const K& value) const
+    requires (bimap_impl::transparent<CompareLeft>)
+  {
+    return this->left_map::find(value, &left());
+  }
+
   right_iterator find_right(const right_t& value) const {
     return this->right_map::find(value, &right());
   }
 
+  template <typename K>
+  right_iterator find_right(const K& value) const
+    requires (bimap_impl::transparent<CompareRight>)
+  {
+    return this->right_map::find(value, &right());
+  }
+
   const right_t& at_left(const left_t& key) const {
     return this->left_map::at(key, &left());
   }
 
+  template <typename K>
+  const right_t& at_left(const K& key) const
+    requires (bimap_impl::transparent<CompareLeft>)
+  {
+    return this->left_map::at(key, &left());
+  }
+
   const left_t& at_right(const right_t& key) const {
     return this->right_map::at(key, &right());
   }
 
+  template <typename K>
+  const left_t& at_right(const K& key) const
+    requires (bimap_impl::transparent<CompareRight>)
+  {
+    return this->right_map::at(key, &right());
+  }
+
   const right_t& at_left_or_default(const left_t& key)
     requires (std::is_default_constructible_v<right_t>)
   {
-    if (this->left_map::at_or_default(key, &left())) {
-      return at_left(key);
-    } else {
-      right_t default_value = right_t();
-      if (this->right_map::at_or_default(default_value, &right())) {
-        auto* left_node_ = lower_bound_left(key).get_node();
-        auto* right_node_ = (++lower_bound_right(default_value)).get_node();
-        auto it = find_right(default_value);
-        auto* new_node = new node_t(key, std::move(default_value));
-        erase_right(it);
-        return *insert_node(left_node_, right_node_, new_node).flip();
-      }
-      return *insert(key, std::move(default_value)).flip();
+    auto left_position = this->left_map::locate(key, &left());
+    if (left_position.found) {
+      return *left_iterator(left_position.next).flip();
+    }
+    right_t default_value = right_t();
+    auto right_position = this->right_map::locate(default_value, &right());
+    if (!right_position.found) {
+      return *insert_node(left_position, right_position, pool_.create(key, std::move(default_value))).flip();
     }
+    // The pair with the default value is replaced, the new pair takes its place on the right side.
+    right_iterator replaced(right_position.next);
+    left_node* left_next = left_position.next;
+    if (left_next == replaced.flip().get_node()) {
+      left_next = (++replaced.flip()).get_node();
+    }
+    right_node* right_next = (++right_iterator(replaced)).get_node();
+    auto* new_node = pool_.create(key, std::move(default_value));
+    erase_right(replaced);
+    return *insert_node(left_next, right_next, new_node).flip();
   }
 
   const left_t& at_right_or_default(const right_t& key)
     requires (std::is_default_constructible_v<left_t>)
   {
-    if (this->right_map::at_or_default(key, &right())) {
-      return at_right(key);
-    } else {
-      left_t default_value = left_t();
-      if (this->left_map::at_or_default(default_value, &left())) {
-        auto* left_node_ = (++lower_bound_left(default_value)).get_node();
-        auto* right_node_ = lower_bound_right(key).get_node();
-        auto it = find_left(default_value);
-        auto* new_node = new node_t(std::move(default_value), key);
-        erase_left(it);
-        return *insert_node(left_node_, right_node_, new_node);
-      }
-      return *insert(std::move(default_value), key);
+    auto right_position = this->right_map::locate(key, &right());
+    if (right_position.found) {
+      return *right_iterator(right_position.next).flip();
     }
+    left_t default_value = left_t();
+    auto left_position = this->left_map::locate(default_value, &left());
+    if (!left_position.found) {
+      return *insert_node(left_position, right_position, pool_.create(std::move(default_value), key));
+    }
+    // The pair with the default value is replaced, the new pair takes its place on the left side.
+    left_iterator replaced(left_position.next);
+    right_node* right_next = right_position.next;
+    if (right_next == replaced.flip().get_node()) {
+      right_next = (++replaced.flip()).get_node();
+    }
+    left_node* left_next = (++left_iterator(replaced)).get_node();
+    auto* new_node = pool_.create(std::move(default_value), key);
+    erase_left(replaced);
+    return *insert_node(left_next, right_next, new_node);
   }
 
   left_iterator lower_bound_left(const left_t& value) const {
     return this->left_map::lower_bound(value, &left());
   }
 
+  template <typename K>
+  left_iterator lower_bound_left(const K& value) const
+    requires (bimap_impl::transparent<CompareLeft>)
+  {
+    return this->left_map::lower_bound(value, &left());
+  }
+
   left_iterator upper_bound_left(const left_t& value) const {
     return this->left_map::upper_bound(value, &left());
   }
 
+  template <typename K>
+  left_iterator upper_bound_left(const K& value) const
+    requires (bimap_impl::transparent<CompareLeft>)
+  {
+    return this->left_map::upper_bound(value, &left());
+  }
+
   right_iterator lower_bound_right(const right_t& value) const {
     return this->right_map::lower_bound(value, &right());
   }
 
+  template <typename K>
+  right_iterator lower_bound_right(const K& value) const
+    requires (bimap_impl::transparent<CompareRight>)
+  {
+    return this->right_map::lower_bound(value, &right());
+  }
+
   right_iterator upper_bound_right(const right_t& value) const {
     return this->right_map::upper_bound(value, &right());
   }
 
+  template <typename K>
+  right_iterator upper_bound_right(const K& value) const
+    requires (bimap_impl::transparent<CompareRight>)
+  {
+    return this->right_map::upper_bound(value, &right());
+  }
+
   left_iterator begin_left() const noexcept {
     return this->left_map::begin(&left());
   }
@@ -240,10 +519,8 @@ public:
     left_iterator lhs_it = lhs.begin_left();
     left_iterator rhs_it = rhs.begin_left();
     while (lhs_it != lhs.end_left() && rhs_it != rhs.end_left()) {
-      if (static_cast<const left_map&>(lhs).compare(*lhs_it, *rhs_it) ||
-          static_cast<const left_map&>(lhs).compare(*rhs_it, *lhs_it) ||
-          static_cast<const right_map&>(lhs).compare(*lhs_it.flip(), *rhs_it.flip()) ||
-          static_cast<const right_map&>(lhs).compare(*rhs_it.flip(), *lhs_it.flip())) {
+      if (lhs.compare_left()(*lhs_it, *rhs_it) || lhs.compare_left()(*rhs_it, *lhs_it) ||
+          lhs.compare_right()(*lhs_it.flip(), *rhs_it.flip()) || lhs.compare_right()(*rhs_it.flip(), *lhs_it.flip())) {
         return false;
       }
       lhs_it++;
@@ -257,6 +534,14 @@ public:
   }
 
 private:
+  const CompareLeft& compare_left() const noexcept {
+    return static_cast<const left_map&>(*this).compare;
+  }
+
+  const CompareRight& compare_right() const noexcept {
+    return static_cast<const right_map&>(*this).compare;
+  }
+
   left_node& left() noexcept {
     return static_cast<left_node&>(base);
   }
@@ -273,24 +558,160 @@ private:
     return static_cast<const right_node&>(base);
   }
 
+  struct node_deleter {
+    void operator()(node_t* node) const noexcept {
+      pool->destroy(node);
+    }
+
+    pool_t* pool;
+  };
+
+  // Owns a node that is not linked yet.
+  using node_holder = std::unique_ptr<node_t, node_deleter>;
+
   template <typename Left_t, typename Right_t>
-  left_iterator insert_impl(Left_t&& left, Right_t&& right) {
-    if (find_left(left) == end_left() && find_right(right) == end_right()) {
-      auto* left_node_ = lower_bound_left(left).get_node();
-      auto* right_node_ = lower_bound_right(right).get_node();
-      auto* new_node = new node_t(std::forward<Left_t>(left), std::forward<Right_t>(right));
-      return insert_node(left_node_, right_node_, new_node);
+  node_holder make_node(Left_t&& left_value, Right_t&& right_value) {
+    return node_holder(pool_.create(std::forward<Left_t>(left_value), std::forward<Right_t>(right_value)), {&pool_});
+  }
+
+  void free_node(left_node* node) noexcept {
+    pool_.destroy(static_cast<node_t*>(node));
+    size_--;
+  }
+
+  void destroy_subtree(left_node* node) noexcept {
+    if (node) {
+      destroy_subtree(node->left);
+      destroy_subtree(node->right);
+      std::destroy_at(static_cast<node_t*>(node));
+    }
+  }
+
+  // Links detached nodes into the empty bimap. Nodes sorted on the left key with unique keys take
+  // a sort on the right key and two linear passes, otherwise they are inserted one by one.
+  void build(std::vector<node_holder>& nodes) {
+    auto less_left = [this](const auto& lhs, const auto& rhs) { return compare_left()(lhs->left, rhs->left); };
+    auto less_right = [this](const auto& lhs, const auto& rhs) { return compare_right()(lhs->right, rhs->right); };
+    auto not_less_left = [&](const auto& lhs, const auto& rhs) { return !less_left(lhs, rhs); };
+    auto not_less_right = [&](const auto& lhs, const auto& rhs) { return !less_right(lhs, rhs); };
+
+    if (std::adjacent_find(nodes.begin(), nodes.end(), not_less_left) != nodes.end()) {
+      std::stable_sort(nodes.begin(), nodes.end(), less_left);
+      if (std::adjacent_find(nodes.begin(), nodes.end(), not_less_left) != nodes.end()) {
+        insert_nodes(nodes);
+        return;
+      }
+    }
+    std::vector<node_t*> by_right;
+    by_right.reserve(nodes.size());
+    for (const auto& node : nodes) {
+      by_right.push_back(node.get());
+    }
+    std::sort(by_right.begin(), by_right.end(), less_right);
+    if (std::adjacent_find(by_right.begin(), by_right.end(), not_less_right) != by_right.end()) {
+      insert_nodes(nodes);
+      return;
+    }
+
+    left_node* last_left = &left();
+    right_node* last_right = &right();
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+      // Every node is appended after the greatest one, so it only climbs the right spine.
+      last_left->attach(nodes[i].get(), last_left == &left());
+      last_left = nodes[i].release();
+      last_right->attach(by_right[i], last_right == &right());
+      last_right = by_right[i];
     }
-    return end_left();
+    size_ = nodes.size();
+  }
+
+  void insert_nodes(std::vector<node_holder>& nodes) {
+    for (auto& node : nodes) {
+      auto left_position = this->left_map::locate(node->left, &left());
+      if (left_position.found) {
+        continue;
+      }
+      auto right_position = this->right_map::locate(node->right, &right());
+      if (right_position.found) {
+        continue;
+      }
+      insert_node(left_position, right_position, node.release());
+    }
+  }
+
+  template <typename K>
+  bool erase_left_impl(const K& value) {
+    auto position = this->left_map::locate(value, &left());
+    if (!position.found) {
+      return false;
+    }
+    erase_left(left_iterator(position.next));
+    return true;
+  }
+
+  template <typename K>
+  bool erase_right_impl(const K& value) {
+    auto position = this->right_map::locate(value, &right());
+    if (!position.found) {
+      return false;
+    }
+    erase_right(right_iterator(position.next));
+    return true;
+  }
+
+  template <typename Left_t, typename Right_t>
+  left_iterator insert_impl(Left_t&& left_value, Right_t&& right_value) {
+    auto left_position = this->left_map::locate(left_value, &left());
+    if (left_position.found) {
+      return end_left();
+    }
+    auto right_position = this->right_map::locate(right_value, &right());
+    if (right_position.found) {
+      return end_left();
+    }
+    auto* new_node = pool_.create(std::forward<Left_t>(left_value), std::forward<Right_t>(right_value));
+    return insert_node(left_position, right_position, new_node);
+  }
+
+  template <typename Left_t, typename Right_t>
+  left_iterator insert_impl(
+      left_iterator hint_left,
+      right_iterator hint_right,
+      Left_t&& left_value,
+      Right_t&& right_value
+  ) {
+    auto left_position = this->left_map::locate(left_value, hint_left, &left());
+    if (left_position.found) {
+      return end_left();
+    }
+    auto right_position = this->right_map::locate(right_value, hint_right, &right());
+    if (right_position.found) {
+      return end_left();
+    }
+    auto* new_node = pool_.create(std::forward<Left_t>(left_value), std::forward<Right_t>(right_value));
+    return insert_node(left_position, right_position, new_node);
+  }
+
+  left_iterator insert_node(
+      const typename left_map::position& left_position,
+      const typename right_map::position& right_position,
+      node_t* new_node
+  ) noexcept {
+    left_position.parent->attach(new_node, left_position.as_left);
+    right_position.parent->attach(new_node, right_position.as_left);
+    size_++;
+    return left_iterator(new_node);
   }
 
-  left_iterator insert_node(left_node* left_node_, right_node* right_node_, node_t* new_node) {
-    left_node_->set_new_node(new_node);
-    right_node_->set_new_node(new_node);
+  // Links the node right before the given ones.
+  left_iterator insert_node(left_node* left_next, right_node* right_next, node_t* new_node) noexcept {
+    left_next->attach_before(new_node);
+    right_next->attach_before(new_node);
     size_++;
     return left_iterator(new_node);
   }
 
   size_t size_ = 0;
   bimap_impl::sentinel_node base;
+  pool_t pool_;
 };
@@ -80,7 +80,7 @@ public:
   }
 
   friend bool operator==(const bimap_iterator& lhs, const bimap_iterator& rhs) noexcept {
-    return *lhs.node_ == *rhs.node_;
+    return lhs.node_ == rhs.node_;
   }
 
   friend bool operator!=(const bimap_iterator& lhs, const bimap_iterator& rhs) noexcept {
@@ -90,7 +90,7 @@ public:
 private:
   template <typename Tag2, typename Current2, typename Another2, typename Compare>
   friend class map;
-  template <typename Left, typename Right, typename CompareLeft, typename CompareRight>
+  template <typename Left, typename Right, typename CompareLeft, typename CompareRight, typename Allocator>
   friend class ::bimap;
 
   node<Tag>* get_node() {
@@ -31,7 +31,7 @@ public:
 private:
   template <typename Tag, typename Current, typename Another, typename Compare>
   friend class map;
-  template <typename L, typename R, typename CompareLeft, typename CompareRight>
+  template <typename L, typename R, typename CompareLeft, typename CompareRight, typename Allocator>
   friend class ::bimap;
   template <typename Tag, typename Current, typename Another>
   friend class bimap_iterator;
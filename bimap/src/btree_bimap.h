@@ -0,0 +1,306 @@
+#pragma once
+
+#include "btree_map.h"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Bimap with the same interface as bimap, but both sides are B-trees that store their keys in
+// the nodes, which keeps lookups in large maps from missing the cache on every level.
+// Unlike bimap, insertion and erasure invalidate all iterators, and keys must be nothrow movable.
+template <
+    typename Left,
+    typename Right,
+    typename CompareLeft = std::less<Left>,
+    typename CompareRight = std::less<Right>>
+class btree_bimap
+    : private bimap_impl::btree_map<bimap_impl::left_tag, Left, Right, CompareLeft>
+    , private bimap_impl::btree_map<bimap_impl::right_tag, Right, Left, CompareRight> {
+public:
+  using left_t = Left;
+  using right_t = Right;
+  using left_iterator = bimap_impl::btree_iterator<bimap_impl::left_tag, Left, Right>;
+  using right_iterator = bimap_impl::btree_iterator<bimap_impl::right_tag, Right, Left>;
+  using left_map = bimap_impl::btree_map<bimap_impl::left_tag, Left, Right, CompareLeft>;
+  using right_map = bimap_impl::btree_map<bimap_impl::right_tag, Right, Left, CompareRight>;
+
+public:
+  btree_bimap(CompareLeft compare_left = CompareLeft(), CompareRight compare_right = CompareRight())
+      : left_map(std::move(compare_left))
+      , right_map(std::move(compare_right)) {}
+
+  btree_bimap(const btree_bimap& other)
+      : left_map(other.compare_left())
+      , right_map(other.compare_right()) {
+    try {
+      for (left_iterator it = other.begin_left(); it != other.end_left(); it++) {
+        insert(*it, *it.flip());
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  btree_bimap(btree_bimap&& other) noexcept
+      : left_map(std::move(static_cast<left_map&>(other).compare))
+      , right_map(std::move(static_cast<right_map&>(other).compare))
+      , size_(std::exchange(other.size_, 0))
+      , header_(std::exchange(other.header_, {})) {}
+
+  btree_bimap& operator=(const btree_bimap& other) {
+    if (this != &other) {
+      *this = btree_bimap(other);
+    }
+    return *this;
+  }
+
+  btree_bimap& operator=(btree_bimap&& other) noexcept {
+    if (this != &other) {
+      btree_bimap tmp(std::move(other));
+      swap(tmp, *this);
+    }
+    return *this;
+  }
+
+  ~btree_bimap() {
+    clear();
+  }
+
+  friend void swap(btree_bimap& lhs, btree_bimap& rhs) noexcept {
+    using std::swap;
+    swap(lhs.size_, rhs.size_);
+    swap(lhs.header_, rhs.header_);
+    swap(static_cast<left_map&>(lhs), static_cast<left_map&>(rhs));
+    swap(static_cast<right_map&>(lhs), static_cast<right_map&>(rhs));
+  }
+
+  left_iterator insert(const left_t& left, const right_t& right) {
+    return insert_impl(left, right);
+  }
+
+  left_iterator insert(const left_t& left, right_t&& right) {
+    return insert_impl(left, std::move(right));
+  }
+
+  left_iterator insert(left_t&& left, const right_t& right) {
+    return insert_impl(std::move(left), right);
+  }
+
+  left_iterator insert(left_t&& left, right_t&& right) {
+    return insert_impl(std::move(left), std::move(right));
+  }
+
+  left_iterator erase_left(left_iterator it) {
+    return erase_impl<left_map, right_map>(it);
+  }
+
+  right_iterator erase_right(right_iterator it) {
+    return erase_impl<right_map, left_map>(it);
+  }
+
+  bool erase_left(const left_t& value) {
+    left_iterator it = find_left(value);
+    if (it == end_left()) {
+      return false;
+    }
+    erase_left(it);
+    return true;
+  }
+
+  bool erase_right(const right_t& value) {
+    right_iterator it = find_right(value);
+    if (it == end_right()) {
+      return false;
+    }
+    erase_right(it);
+    return true;
+  }
+
+  left_iterator erase_left(left_iterator first, left_iterator last) {
+    for (auto count = std::distance(first, last); count > 0; --count) {
+      first = erase_left(first);
+    }
+    return first;
+  }
+
+  right_iterator erase_right(right_iterator first, right_iterator last) {
+    for (auto count = std::distance(first, last); count > 0; --count) {
+      first = erase_right(first);
+    }
+    return first;
+  }
+
+  left_iterator find_left(const left_t& value) const {
+    return this->left_map::find(value, &header_);
+  }
+
+  right_iterator find_right(const right_t& value) const {
+    return this->right_map::find(value, &header_);
+  }
+
+  const right_t& at_left(const left_t& key) const {
+    return this->left_map::at(key, &header_);
+  }
+
+  const left_t& at_right(const right_t& key) const {
+    return this->right_map::at(key, &header_);
+  }
+
+  const right_t& at_left_or_default(const left_t& key)
+    requires (std::is_default_constructible_v<right_t>)
+  {
+    left_iterator it = find_left(key);
+    if (it != end_left()) {
+      return *it.flip();
+    }
+    left_t left(key);
+    right_t right = right_t();
+    erase_right(right);
+    return *insert(std::move(left), std::move(right)).flip();
+  }
+
+  const left_t& at_right_or_default(const right_t& key)
+    requires (std::is_default_constructible_v<left_t>)
+  {
+    right_iterator it = find_right(key);
+    if (it != end_right()) {
+      return *it.flip();
+    }
+    right_t right(key);
+    left_t left = left_t();
+    erase_left(left);
+    return *insert(std::move(left), std::move(right));
+  }
+
+  left_iterator lower_bound_left(const left_t& value) const {
+    return this->left_map::lower_bound(value, &header_);
+  }
+
+  left_iterator upper_bound_left(const left_t& value) const {
+    return this->left_map::upper_bound(value, &header_);
+  }
+
+  right_iterator lower_bound_right(const right_t& value) const {
+    return this->right_map::lower_bound(value, &header_);
+  }
+
+  right_iterator upper_bound_right(const right_t& value) const {
+    return this->right_map::upper_bound(value, &header_);
+  }
+
+  left_iterator begin_left() const noexcept {
+    return this->left_map::begin(&header_);
+  }
+
+  left_iterator end_left() const noexcept {
+    return this->left_map::end(&header_);
+  }
+
+  right_iterator begin_right() const noexcept {
+    return this->right_map::begin(&header_);
+  }
+
+  right_iterator end_right() const noexcept {
+    return this->right_map::end(&header_);
+  }
+
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  std::size_t size() const noexcept {
+    return size_;
+  }
+
+  friend bool operator==(const btree_bimap& lhs, const btree_bimap& rhs) {
+    if (lhs.size() != rhs.size()) {
+      return false;
+    }
+    left_iterator lhs_it = lhs.begin_left();
+    left_iterator rhs_it = rhs.begin_left();
+    while (lhs_it != lhs.end_left() && rhs_it != rhs.end_left()) {
+      if (lhs.compare_left()(*lhs_it, *rhs_it) || lhs.compare_left()(*rhs_it, *lhs_it) ||
+          lhs.compare_right()(*lhs_it.flip(), *rhs_it.flip()) || lhs.compare_right()(*rhs_it.flip(), *lhs_it.flip())) {
+        return false;
+      }
+      lhs_it++;
+      rhs_it++;
+    }
+    return true;
+  }
+
+  friend bool operator!=(const btree_bimap& lhs, const btree_bimap& rhs) {
+    return !(lhs == rhs);
+  }
+
+private:
+  const CompareLeft& compare_left() const noexcept {
+    return static_cast<const left_map&>(*this).compare;
+  }
+
+  const CompareRight& compare_right() const noexcept {
+    return static_cast<const right_map&>(*this).compare;
+  }
+
+  void clear() noexcept {
+    left_map::clear(&header_);
+    right_map::clear(&header_);
+    size_ = 0;
+  }
+
+  template <typename Left_t, typename Right_t>
+  left_iterator insert_impl(Left_t&& left, Right_t&& right) {
+    auto left_location = this->left_map::search(left, &header_);
+    if (left_location.found) {
+      return end_left();
+    }
+    auto right_location = this->right_map::search(right, &header_);
+    if (right_location.found) {
+      return end_left();
+    }
+    // Keys are constructed before the trees change, so that a throwing constructor leaves them intact.
+    left_t left_value(std::forward<Left_t>(left));
+    right_t right_value(std::forward<Right_t>(right));
+    auto [left_node, left_index] = left_map::insert(&header_, left_location, std::move(left_value));
+    try {
+      auto [right_node, right_index] = right_map::insert(&header_, right_location, std::move(right_value));
+      left_node->link(left_index, right_node, right_index);
+      right_node->link(right_index, left_node, left_index);
+    } catch (...) {
+      left_map::erase(&header_, left_node, left_index);
+      throw;
+    }
+    size_++;
+    return left_iterator(&header_, left_node, left_index);
+  }
+
+  // Keys of the opposite tree stay in place while this tree is rebalanced, so the next key
+  // is found again through its paired key.
+  template <typename Map, typename Other, typename Iterator>
+  Iterator erase_impl(Iterator it) {
+    auto* node = const_cast<typename Map::node_t*>(it.node_);
+    std::size_t index = it.index_;
+    Other::erase(&header_, node->partners[index], node->partner_positions[index]);
+    Iterator next = std::next(it);
+    size_--;
+    if (next == Iterator(&header_, nullptr, 0)) {
+      Map::erase(&header_, node, index);
+      return next;
+    }
+    auto* next_partner = next.node_->partners[next.index_];
+    std::size_t next_partner_index = next.node_->partner_positions[next.index_];
+    Map::erase(&header_, node, index);
+    return Iterator(
+        &header_,
+        next_partner->partners[next_partner_index],
+        next_partner->partner_positions[next_partner_index]
+    );
+  }
+
+  std::size_t size_ = 0;
+  typename left_map::header_t header_;
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "bimap_iterator.h"
+#include "btree_node.h"
+
+#include <cstddef>
+#include <iterator>
+
+namespace bimap_impl {
+// Iterator over one side of a btree_bimap. The end iterator has no node, decrementing it
+// descends to the last key through the header.
+template <typename Tag, typename Current, typename Another>
+class btree_iterator {
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = Current;
+  using reference = const Current&;
+  using pointer = const Current*;
+
+  btree_iterator() noexcept = default;
+
+  reference operator*() const noexcept {
+    return node_->key(index_);
+  }
+
+  pointer operator->() const noexcept {
+    return &node_->key(index_);
+  }
+
+  btree_iterator& operator++() noexcept {
+    if (!node_->leaf) {
+      node_ = node_->child(index_ + 1);
+      while (!node_->leaf) {
+        node_ = node_->child(0);
+      }
+      index_ = 0;
+    } else if (index_ + 1 < node_->count) {
+      ++index_;
+    } else {
+      while (node_->parent && node_->position == node_->parent->count) {
+        node_ = node_->parent;
+      }
+      index_ = node_->position;
+      node_ = node_->parent;
+    }
+    return *this;
+  }
+
+  btree_iterator operator++(int) noexcept {
+    btree_iterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  btree_iterator& operator--() noexcept {
+    if (!node_) {
+      node_ = root();
+      while (!node_->leaf) {
+        node_ = node_->child(node_->count);
+      }
+      index_ = node_->count - 1;
+    } else if (!node_->leaf) {
+      node_ = node_->child(index_);
+      while (!node_->leaf) {
+        node_ = node_->child(node_->count);
+      }
+      index_ = node_->count - 1;
+    } else if (index_ > 0) {
+      --index_;
+    } else {
+      while (node_->parent && node_->position == 0) {
+        node_ = node_->parent;
+      }
+      index_ = node_->position - 1;
+      node_ = node_->parent;
+    }
+    return *this;
+  }
+
+  btree_iterator operator--(int) noexcept {
+    btree_iterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  btree_iterator<typename opposite_tag<Tag>::type, Another, Current> flip() const noexcept {
+    if (!node_) {
+      return {header_, nullptr, 0};
+    }
+    return {header_, node_->partners[index_], node_->partner_positions[index_]};
+  }
+
+  friend bool operator==(const btree_iterator& lhs, const btree_iterator& rhs) noexcept {
+    return lhs.node_ == rhs.node_ && lhs.index_ == rhs.index_;
+  }
+
+  friend bool operator!=(const btree_iterator& lhs, const btree_iterator& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+private:
+  using node_t = btree_node<Current, Another>;
+  using header_t = std::conditional_t<
+      std::is_same_v<Tag, left_tag>,
+      btree_header<Current, Another>,
+      btree_header<Another, Current>>;
+
+  btree_iterator(const header_t* header, const node_t* node, std::size_t index) noexcept
+      : header_(header)
+      , node_(node)
+      , index_(index) {}
+
+  const node_t* root() const noexcept {
+    if constexpr (std::is_same_v<Tag, left_tag>) {
+      return header_->left_root;
+    } else {
+      return header_->right_root;
+    }
+  }
+
+  template <typename Tag2, typename Current2, typename Another2>
+  friend class btree_iterator;
+  template <typename Tag2, typename Current2, typename Another2, typename Compare>
+  friend class btree_map;
+  template <typename Left, typename Right, typename CompareLeft, typename CompareRight>
+  friend class ::btree_bimap;
+
+  const header_t* header_ = nullptr;
+  const node_t* node_ = nullptr;
+  std::size_t index_ = 0;
+};
+} // namespace bimap_impl
@@ -0,0 +1,291 @@
+#pragma once
+
+#include "btree_iterator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace bimap_impl {
+// One side of a btree_bimap: a B-tree of the keys of this side, rooted in the shared header.
+template <typename Tag, typename Current, typename Another, typename Compare>
+class btree_map {
+public:
+  using iterator = btree_iterator<Tag, Current, Another>;
+  using value_t = Current;
+  using flip_t = Another;
+  using node_t = btree_node<Current, Another>;
+  using header_t = typename iterator::header_t;
+
+  // Slot of a key, or the slot of a leaf where the key would be inserted if it is not found.
+  struct location {
+    node_t* node;
+    std::size_t index;
+    bool found;
+  };
+
+  btree_map(const Compare& compare)
+      : compare(compare) {}
+
+  btree_map(Compare&& compare)
+      : compare(std::move(compare)) {}
+
+  friend void swap(btree_map& lhs, btree_map& rhs) noexcept {
+    using std::swap;
+    swap(lhs.compare, rhs.compare);
+  }
+
+  location search(const value_t& value, const header_t* header) const {
+    node_t* node = const_cast<node_t*>(root(header));
+    if (!node) {
+      return {nullptr, 0, false};
+    }
+    auto less = [this](const value_t& lhs, const value_t& rhs) { return compare(lhs, rhs); };
+    while (true) {
+      const value_t* keys = node->keys();
+      std::size_t index = std::lower_bound(keys, keys + node->count, value, less) - keys;
+      if (index < node->count && !compare(value, keys[index])) {
+        return {node, index, true};
+      }
+      if (node->leaf) {
+        return {node, index, false};
+      }
+      node = node->child(index);
+    }
+  }
+
+  iterator find(const value_t& value, const header_t* header) const {
+    location loc = search(value, header);
+    return loc.found ? iterator(header, loc.node, loc.index) : end(header);
+  }
+
+  const flip_t& at(const value_t& key, const header_t* header) const {
+    location loc = search(key, header);
+    if (!loc.found) {
+      throw std::out_of_range("Index is out of range");
+    }
+    return *iterator(header, loc.node, loc.index).flip();
+  }
+
+  iterator lower_bound(const value_t& value, const header_t* header) const {
+    location loc = search(value, header);
+    if (loc.node && loc.index == loc.node->count) {
+      iterator it(header, loc.node, loc.index - 1);
+      return ++it;
+    }
+    return iterator(header, loc.node, loc.index);
+  }
+
+  iterator upper_bound(const value_t& value, const header_t* header) const {
+    iterator it = lower_bound(value, header);
+    if (it != end(header) && !compare(value, *it)) {
+      ++it;
+    }
+    return it;
+  }
+
+  iterator begin(const header_t* header) const noexcept {
+    const node_t* node = root(header);
+    if (!node) {
+      return end(header);
+    }
+    while (!node->leaf) {
+      node = node->child(0);
+    }
+    return iterator(header, node, 0);
+  }
+
+  iterator end(const header_t* header) const noexcept {
+    return iterator(header, nullptr, 0);
+  }
+
+  // Inserts a key to the slot found by search() and returns where it ends up.
+  // Splits full nodes on the way up, so other keys may move.
+  static std::pair<node_t*, std::size_t> insert(header_t* header, location loc, value_t&& value) {
+    node_t* node = loc.node;
+    std::size_t index = loc.index;
+    if (!node) {
+      node = node_t::create(true);
+      root(header) = node;
+    } else if (node->count == node_t::max_keys) {
+      std::tie(node, index) = split(header, node, index);
+    }
+    node->shift_right(index);
+    node->construct(index, std::move(value));
+    node->count++;
+    return {node, index};
+  }
+
+  // Erases the key at the slot, other keys may move.
+  static void erase(header_t* header, node_t* node, std::size_t index) noexcept {
+    std::destroy_at(&node->key(index));
+    if (!node->leaf) {
+      node_t* leaf = node->child(index);
+      while (!leaf->leaf) {
+        leaf = leaf->child(leaf->count);
+      }
+      node->transfer(index, leaf, leaf->count - 1);
+      leaf->count--;
+      node = leaf;
+    } else {
+      node->shift_left(index + 1);
+      node->count--;
+    }
+    rebalance(header, node);
+  }
+
+  static void clear(header_t* header) noexcept {
+    if (root(header)) {
+      node_t::destroy(root(header));
+      root(header) = nullptr;
+    }
+  }
+
+private:
+  static node_t*& root(header_t* header) noexcept {
+    if constexpr (std::is_same_v<Tag, left_tag>) {
+      return header->left_root;
+    } else {
+      return header->right_root;
+    }
+  }
+
+  static const node_t* root(const header_t* header) noexcept {
+    return root(const_cast<header_t*>(header));
+  }
+
+  // Moves the upper half of a full node to a new sibling and its middle key to the parent,
+  // returns the new slot of the key at `index`.
+  static std::pair<node_t*, std::size_t> split(header_t* header, node_t* node, std::size_t index) {
+    if (node->parent && node->parent->count == node_t::max_keys) {
+      split(header, node->parent, node->position);
+    }
+    node_t* sibling = node_t::create(node->leaf);
+    node_t* parent = node->parent;
+    if (!parent) {
+      try {
+        parent = node_t::create(false);
+      } catch (...) {
+        node_t::release(sibling);
+        throw;
+      }
+      parent->set_child(0, node);
+      root(header) = parent;
+    }
+    constexpr std::size_t middle = node_t::min_keys;
+    for (std::size_t ind = 0; ind < node_t::min_keys; ++ind) {
+      sibling->transfer(ind, node, middle + 1 + ind);
+    }
+    if (!node->leaf) {
+      for (std::size_t ind = 0; ind <= node_t::min_keys; ++ind) {
+        sibling->set_child(ind, node->child(middle + 1 + ind));
+      }
+    }
+    sibling->count = node_t::min_keys;
+    std::size_t position = node->position;
+    parent->shift_right(position);
+    for (std::size_t ind = parent->count; ind > position; --ind) {
+      parent->set_child(ind + 1, parent->child(ind));
+    }
+    parent->transfer(position, node, middle);
+    parent->set_child(position + 1, sibling);
+    parent->count++;
+    node->count = middle;
+    if (index <= middle) {
+      return {node, index};
+    }
+    return {sibling, index - middle - 1};
+  }
+
+  static void rebalance(header_t* header, node_t* node) noexcept {
+    while (node->parent) {
+      if (node->count >= node_t::min_keys) {
+        return;
+      }
+      node_t* parent = node->parent;
+      std::size_t position = node->position;
+      if (position > 0 && parent->child(position - 1)->count > node_t::min_keys) {
+        rotate_right(parent, position - 1);
+        return;
+      }
+      if (position < parent->count && parent->child(position + 1)->count > node_t::min_keys) {
+        rotate_left(parent, position);
+        return;
+      }
+      merge(parent, position > 0 ? position - 1 : position);
+      node = parent;
+    }
+    if (node->count == 0) {
+      root(header) = node->leaf ? nullptr : node->child(0);
+      if (root(header)) {
+        root(header)->parent = nullptr;
+      }
+      node_t::release(node);
+    }
+  }
+
+  // Moves the last key of the child `index` through the parent to the next child.
+  static void rotate_right(node_t* parent, std::size_t index) noexcept {
+    node_t* left = parent->child(index);
+    node_t* right = parent->child(index + 1);
+    right->shift_right(0);
+    if (!right->leaf) {
+      for (std::size_t ind = right->count + 1; ind > 0; --ind) {
+        right->set_child(ind, right->child(ind - 1));
+      }
+      right->set_child(0, left->child(left->count));
+    }
+    right->transfer(0, parent, index);
+    parent->transfer(index, left, left->count - 1);
+    left->count--;
+    right->count++;
+  }
+
+  // Moves the first key of the child `index + 1` through the parent to the previous child.
+  static void rotate_left(node_t* parent, std::size_t index) noexcept {
+    node_t* left = parent->child(index);
+    node_t* right = parent->child(index + 1);
+    left->transfer(left->count, parent, index);
+    parent->transfer(index, right, 0);
+    if (!right->leaf) {
+      left->set_child(left->count + 1, right->child(0));
+      for (std::size_t ind = 0; ind < right->count; ++ind) {
+        right->set_child(ind, right->child(ind + 1));
+      }
+    }
+    right->shift_left(1);
+    left->count++;
+    right->count--;
+  }
+
+  // Merges the child `index + 1` and the key between them into the child `index`.
+  static void merge(node_t* parent, std::size_t index) noexcept {
+    node_t* left = parent->child(index);
+    node_t* right = parent->child(index + 1);
+    left->transfer(left->count, parent, index);
+    for (std::size_t ind = 0; ind < right->count; ++ind) {
+      left->transfer(left->count + 1 + ind, right, ind);
+    }
+    if (!left->leaf) {
+      for (std::size_t ind = 0; ind <= right->count; ++ind) {
+        left->set_child(left->count + 1 + ind, right->child(ind));
+      }
+    }
+    left->count += right->count + 1;
+    parent->shift_left(index + 1);
+    for (std::size_t ind = index + 2; ind <= parent->count; ++ind) {
+      parent->set_child(ind - 1, parent->child(ind));
+    }
+    parent->count--;
+    node_t::release(right);
+  }
+
+  template <typename Left, typename Right, typename CompareLeft, typename CompareRight>
+  friend class ::btree_bimap;
+
+  [[no_unique_address]] Compare compare;
+};
+} // namespace bimap_impl
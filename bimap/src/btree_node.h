@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Left, typename Right, typename CompareLeft, typename CompareRight>
+class btree_bimap;
+
+namespace bimap_impl {
+// Node of a B-tree holding the keys of one side of a btree_bimap. Keys are stored in the nodes
+// themselves, so a lookup touches a few contiguous arrays instead of a node per comparison.
+// Every key knows where the paired key of the opposite tree lives, the location is updated
+// whenever either key moves to another slot.
+template <typename Key, typename Other>
+class btree_node {
+public:
+  using partner_t = btree_node<Other, Key>;
+
+  // Nodes of non-root keep between min_keys and max_keys keys, about 256 bytes of them.
+  static constexpr std::size_t min_keys = std::clamp<std::size_t>(128 / sizeof(Key), 2, 31);
+  static constexpr std::size_t max_keys = 2 * min_keys + 1;
+
+  static_assert(std::is_nothrow_move_constructible_v<Key>, "keys of a btree_bimap must be nothrow movable");
+
+  explicit btree_node(bool is_leaf) noexcept
+      : leaf(is_leaf) {}
+
+  btree_node(const btree_node&) = delete;
+  btree_node& operator=(const btree_node&) = delete;
+
+  static btree_node* create(bool is_leaf) {
+    if (is_leaf) {
+      return new btree_node(true);
+    }
+    return new inner_node();
+  }
+
+  // Frees the node without destroying its keys, they must have been moved out already.
+  static void release(btree_node* node) noexcept {
+    if (node->leaf) {
+      delete node;
+    } else {
+      delete static_cast<inner_node*>(node);
+    }
+  }
+
+  // Destroys the keys and frees the whole subtree.
+  static void destroy(btree_node* node) noexcept {
+    if (!node->leaf) {
+      for (std::size_t ind = 0; ind <= node->count; ++ind) {
+        destroy(node->child(ind));
+      }
+    }
+    std::destroy_n(node->keys(), node->count);
+    release(node);
+  }
+
+  Key* keys() noexcept {
+    return std::launder(reinterpret_cast<Key*>(storage));
+  }
+
+  const Key* keys() const noexcept {
+    return std::launder(reinterpret_cast<const Key*>(storage));
+  }
+
+  Key& key(std::size_t index) noexcept {
+    return keys()[index];
+  }
+
+  const Key& key(std::size_t index) const noexcept {
+    return keys()[index];
+  }
+
+  btree_node*& child(std::size_t index) noexcept {
+    return static_cast<inner_node*>(this)->children[index];
+  }
+
+  btree_node* child(std::size_t index) const noexcept {
+    return static_cast<const inner_node*>(this)->children[index];
+  }
+
+  void set_child(std::size_t index, btree_node* node) noexcept {
+    child(index) = node;
+    node->parent = this;
+    node->position = static_cast<std::uint16_t>(index);
+  }
+
+  template <typename... Args>
+  void construct(std::size_t index, Args&&... args) noexcept {
+    new (storage + index * sizeof(Key)) Key(std::forward<Args>(args)...);
+    partners[index] = nullptr;
+    partner_positions[index] = 0;
+  }
+
+  void link(std::size_t index, partner_t* partner, std::size_t partner_position) noexcept {
+    partners[index] = partner;
+    partner_positions[index] = static_cast<std::uint16_t>(partner_position);
+  }
+
+  // Moves a key with its link to the uninitialized slot `index` and lets the paired key know.
+  void transfer(std::size_t index, btree_node* src, std::size_t src_index) noexcept {
+    construct(index, std::move(src->key(src_index)));
+    std::destroy_at(&src->key(src_index));
+    link(index, src->partners[src_index], src->partner_positions[src_index]);
+    if (partners[index]) {
+      partners[index]->link(partner_positions[index], this, index);
+    }
+  }
+
+  // Shifts the keys [first, count) by one slot to the right.
+  void shift_right(std::size_t first) noexcept {
+    for (std::size_t ind = count; ind > first; --ind) {
+      transfer(ind, this, ind - 1);
+    }
+  }
+
+  // Shifts the keys [first, count) by one slot to the left, the slot first - 1 must be uninitialized.
+  void shift_left(std::size_t first) noexcept {
+    for (std::size_t ind = first; ind < count; ++ind) {
+      transfer(ind - 1, this, ind);
+    }
+  }
+
+  btree_node* parent = nullptr;
+  std::uint16_t position = 0;
+  std::uint16_t count = 0;
+  bool leaf;
+  partner_t* partners[max_keys];
+  std::uint16_t partner_positions[max_keys];
+  alignas(Key) std::byte storage[max_keys * sizeof(Key)];
+
+private:
+  struct inner_node;
+};
+
+template <typename Key, typename Other>
+struct btree_node<Key, Other>::inner_node : btree_node {
+  inner_node() noexcept
+      : btree_node(false) {}
+
+  btree_node* children[max_keys + 1];
+};
+
+// Roots of both trees of a btree_bimap, iterators refer to it to reach the end of a side.
+template <typename Left, typename Right>
+struct btree_header {
+  btree_node<Left, Right>* left_root = nullptr;
+  btree_node<Right, Left>* right_root = nullptr;
+};
+} // namespace bimap_impl
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "bimap.h"
+#include "rcu_domain.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// Bimap for many readers and rare writers. Every version is an immutable bimap: readers take a
+// snapshot of the current one without locking or waiting, and writers change a copy and publish it
+// at once. A version is destroyed when no snapshot can see it any more, so a writer waits for the
+// readers that started before its publication. Writers are serialized and each of them copies the
+// whole bimap, many changes should be made by one update().
+template <
+    typename Left,
+    typename Right,
+    typename CompareLeft = std::less<Left>,
+    typename CompareRight = std::less<Right>,
+    typename Allocator = std::allocator<std::pair<Left, Right>>>
+class concurrent_bimap {
+public:
+  using left_t = Left;
+  using right_t = Right;
+  using bimap_t = bimap<Left, Right, CompareLeft, CompareRight, Allocator>;
+
+  // Keeps a version alive and gives read access to it. Writers wait for the snapshot, so it should
+  // be dropped soon, and a thread must drop its snapshots before it writes.
+  class snapshot {
+  public:
+    snapshot(snapshot&& other) noexcept
+        : domain_(std::exchange(other.domain_, nullptr))
+        , token_(other.token_)
+        , version_(other.version_) {}
+
+    snapshot& operator=(snapshot&&) = delete;
+
+    ~snapshot() {
+      if (domain_) {
+        domain_->read_unlock(token_);
+      }
+    }
+
+    const bimap_t& operator*() const noexcept {
+      return *version_;
+    }
+
+    const bimap_t* operator->() const noexcept {
+      return version_;
+    }
+
+  private:
+    friend class concurrent_bimap;
+
+    snapshot(bimap_impl::rcu_domain& domain, const std::atomic<const bimap_t*>& current) noexcept
+        : domain_(&domain)
+        , token_(domain.read_lock())
+        , version_(current.load()) {}
+
+    bimap_impl::rcu_domain* domain_;
+    bimap_impl::rcu_domain::token token_;
+    const bimap_t* version_;
+  };
+
+public:
+  concurrent_bimap()
+      : concurrent_bimap(bimap_t()) {}
+
+  explicit concurrent_bimap(bimap_t initial)
+      : current_(new bimap_t(std::move(initial))) {}
+
+  concurrent_bimap(const concurrent_bimap&) = delete;
+  concurrent_bimap& operator=(const concurrent_bimap&) = delete;
+
+  // No snapshot may outlive the bimap.
+  ~concurrent_bimap() {
+    delete current_.load(std::memory_order_relaxed);
+  }
+
+  // Wait-free, the snapshot sees the last version published before the call or a later one.
+  snapshot read() const noexcept {
+    return snapshot(domain_, current_);
+  }
+
+  // Applies `change` to a copy of the current version and publishes it. If `change` throws,
+  // nothing is published.
+  template <typename F>
+  void update(F&& change) {
+    std::lock_guard lock(write_mutex_);
+    auto next = std::make_unique<bimap_t>(current());
+    std::invoke(std::forward<F>(change), *next);
+    publish(std::move(next));
+  }
+
+  // Publishes the given bimap as the next version, without copying it.
+  void assign(bimap_t value) {
+    std::lock_guard lock(write_mutex_);
+    publish(std::make_unique<bimap_t>(std::move(value)));
+  }
+
+  // Single changes look the keys up in the current version first and publish nothing if it stays the same.
+  bool insert(left_t left, right_t right) {
+    std::lock_guard lock(write_mutex_);
+    if (current().find_left(left) != current().end_left() || current().find_right(right) != current().end_right()) {
+      return false;
+    }
+    auto next = std::make_unique<bimap_t>(current());
+    next->insert(std::move(left), std::move(right));
+    publish(std::move(next));
+    return true;
+  }
+
+  bool erase_left(const left_t& left) {
+    std::lock_guard lock(write_mutex_);
+    if (current().find_left(left) == current().end_left()) {
+      return false;
+    }
+    auto next = std::make_unique<bimap_t>(current());
+    next->erase_left(left);
+    publish(std::move(next));
+    return true;
+  }
+
+  bool erase_right(const right_t& right) {
+    std::lock_guard lock(write_mutex_);
+    if (current().find_right(right) == current().end_right()) {
+      return false;
+    }
+    auto next = std::make_unique<bimap_t>(current());
+    next->erase_right(right);
+    publish(std::move(next));
+    return true;
+  }
+
+private:
+  // Only writers holding the mutex may call it, the version can't change under them.
+  const bimap_t& current() const noexcept {
+    return *current_.load(std::memory_order_relaxed);
+  }
+
+  void publish(std::unique_ptr<bimap_t> next) noexcept {
+    std::unique_ptr<const bimap_t> old(current_.exchange(next.release()));
+    domain_.synchronize();
+  }
+
+  std::atomic<const bimap_t*> current_;
+  mutable bimap_impl::rcu_domain domain_;
+  std::mutex write_mutex_;
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "unordered_iterator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace bimap_impl {
+// Transparent lookups of an unordered_bimap side need both the hash and the equality to accept other keys.
+template <typename Hash, typename Equal>
+concept transparent_hash = requires {
+  typename Hash::is_transparent;
+  typename Equal::is_transparent;
+};
+
+// One side of an unordered_bimap: an open-addressing table with linear probing that maps the keys of
+// this side to the positions of their pairs in the element array. A slot keeps the upper half of the
+// mixed hash next to the position, so probing rarely touches the keys, and growing the table or
+// deleting with backward shifts never hashes them again.
+template <typename Tag, typename Hash, typename Equal>
+class hash_index {
+public:
+  static constexpr std::uint32_t npos = UINT32_MAX;
+  // Positions are 32-bit and the table is kept at most half full.
+  static constexpr std::size_t max_size = std::size_t(1) << 30;
+
+  hash_index(Hash hash, Equal equal)
+      : hash(std::move(hash))
+      , equal(std::move(equal)) {}
+
+  friend void swap(hash_index& lhs, hash_index& rhs) noexcept {
+    using std::swap;
+    swap(lhs.hash, rhs.hash);
+    swap(lhs.equal, rhs.equal);
+    swap(lhs.slots, rhs.slots);
+    swap(lhs.shift, rhs.shift);
+  }
+
+  // Fibonacci hashing spreads identity hashes such as std::hash<int> over the whole table.
+  template <typename K>
+  std::uint32_t tag_of(const K& key) const {
+    std::uint64_t mixed = static_cast<std::uint64_t>(hash(key)) * 0x9e3779b97f4a7c15;
+    return static_cast<std::uint32_t>(mixed >> 32);
+  }
+
+  // Position of the pair with the key, or npos.
+  template <typename K, typename Element>
+  std::uint32_t find(const K& key, std::uint32_t tag, const std::vector<Element>& elements) const {
+    if (slots.empty()) {
+      return npos;
+    }
+    for (std::size_t ind = home(tag);; ind = next(ind)) {
+      const slot& current = slots[ind];
+      if (current.position == npos) {
+        return npos;
+      }
+      if (current.tag == tag && equal(elements[current.position].template key<Tag>(), key)) {
+        return current.position;
+      }
+    }
+  }
+
+  // Makes room for `count` keys, the only operation that may throw.
+  void reserve(std::size_t count) {
+    if (count * 2 <= slots.size()) {
+      return;
+    }
+    std::size_t capacity = 8;
+    while (capacity < count * 2) {
+      capacity *= 2;
+    }
+    std::vector<slot> old(capacity);
+    swap(old, slots);
+    shift = 32;
+    for (std::size_t ind = capacity; ind > 1; ind /= 2) {
+      shift--;
+    }
+    for (const slot& current : old) {
+      if (current.position != npos) {
+        insert(current.tag, current.position);
+      }
+    }
+  }
+
+  // Adds a key that is not in the table yet, reserve() must have made room for it.
+  void insert(std::uint32_t tag, std::uint32_t position) noexcept {
+    std::size_t ind = home(tag);
+    while (slots[ind].position != npos) {
+      ind = next(ind);
+    }
+    slots[ind] = {position, tag};
+  }
+
+  // Removes the key of the pair at `position`, the later keys of its cluster are shifted back
+  // so that no probe sequence gets broken.
+  void erase(std::uint32_t tag, std::uint32_t position) noexcept {
+    std::size_t hole = locate(tag, position);
+    for (std::size_t ind = next(hole); slots[ind].position != npos; ind = next(ind)) {
+      std::size_t distance = (ind - home(slots[ind].tag)) & mask();
+      if (distance >= ((ind - hole) & mask())) {
+        slots[hole] = slots[ind];
+        hole = ind;
+      }
+    }
+    slots[hole] = slot();
+  }
+
+  // Points the key of a pair that moved to another position to it.
+  void relink(std::uint32_t tag, std::uint32_t from, std::uint32_t to) noexcept {
+    slots[locate(tag, from)].position = to;
+  }
+
+private:
+  struct slot {
+    std::uint32_t position = npos;
+    std::uint32_t tag = 0;
+  };
+
+  std::size_t home(std::uint32_t tag) const noexcept {
+    return tag >> shift;
+  }
+
+  std::size_t mask() const noexcept {
+    return slots.size() - 1;
+  }
+
+  std::size_t next(std::size_t ind) const noexcept {
+    return (ind + 1) & mask();
+  }
+
+  std::size_t locate(std::uint32_t tag, std::uint32_t position) const noexcept {
+    std::size_t ind = home(tag);
+    while (slots[ind].position != position) {
+      ind = next(ind);
+    }
+    return ind;
+  }
+
+  template <
+      typename Left,
+      typename Right,
+      typename HashLeft,
+      typename HashRight,
+      typename EqualLeft,
+      typename EqualRight>
+  friend class ::unordered_bimap;
+
+  [[no_unique_address]] Hash hash;
+  [[no_unique_address]] Equal equal;
+  std::vector<slot> slots;
+  unsigned shift = 32;
+};
+} // namespace bimap_impl
@@ -3,6 +3,10 @@
 #include "bimap_iterator.h"
 
 namespace bimap_impl {
+// Comparators that declare is_transparent accept any key comparable with the stored ones.
+template <typename Compare>
+concept transparent = requires { typename Compare::is_transparent; };
+
 template <typename Tag, typename Current, typename Another, typename Compare>
 class map {
 public:
@@ -24,84 +28,106 @@ public:
     swap(lhs.compare, rhs.compare);
   }
 
-  iterator erase(iterator it) {
+  // Unlinks the node of the iterator from both sides, it is up to the bimap to free it.
+  static iterator unlink(iterator it) noexcept {
     auto res = it;
     res++;
     it.get_node()->erase();
     it.flip().get_node()->erase();
-    delete (static_cast<node_t*>(it.get_node()));
     return res;
   }
 
-  bool erase(const value_t& value, node<Tag>* node) {
-    auto it = lower_bound(value, node);
-    if (it != end(node) && *it == value) {
-      erase(it);
-      return true;
-    }
-    return false;
-  }
-
-  iterator erase(iterator first, iterator last) {
-    while (first != last) {
-      erase(first++);
-    }
-    return last;
-  }
-
-  iterator find(const value_t& value, const node<Tag>* node) const {
-    auto res = lower_bound(value, node);
-    return res == end(node) || compare(*res, value) || compare(value, *res) ? end(node) : res;
+  // Lookups take any key type, bimap only passes other types than value_t for transparent comparators.
+  template <typename K>
+  iterator find(const K& value, const node<Tag>* sentinel) const {
+    auto res = lower_bound(value, sentinel);
+    return res == end(sentinel) || compare(value, *res) ? end(sentinel) : res;
   }
 
-  const flip_t& at(const value_t& key, const node<Tag>* node) const {
-    auto it = lower_bound(key, node);
-    if (it == end(node) || *it != key) {
+  template <typename K>
+  const flip_t& at(const K& key, const node<Tag>* sentinel) const {
+    auto it = find(key, sentinel);
+    if (it == end(sentinel)) {
       throw std::out_of_range("Index is out of range");
-    } else {
-      return *(it.flip());
     }
+    return *it.flip();
   }
 
-  bool at_or_default(const value_t& key, node<Tag>* node) {
-    auto it = lower_bound(key, node);
-    return (it != end(node) && *it == key);
+  // Where a value goes: the parent to attach it to and the least element that is not less than it.
+  struct position {
+    node<Tag>* parent;
+    bool as_left;
+    node<Tag>* next;
+    bool found;
+  };
+
+  // Descends once, comparing the value with each node on the path once, and checks the lower bound
+  // for equality at the end.
+  template <typename K>
+  position locate(const K& value, node<Tag>* sentinel) const {
+    position res = {sentinel, true, sentinel, false};
+    for (node<Tag>* current = sentinel->left; current;) {
+      res.parent = current;
+      if (compare(get_value(current), value)) {
+        res.as_left = false;
+        current = current->right;
+      } else {
+        res.as_left = true;
+        res.next = current;
+        current = current->left;
+      }
+    }
+    res.found = res.next != sentinel && !compare(value, get_value(res.next));
+    return res;
   }
 
-  iterator lower_bound(const value_t& value, const node<Tag>* node) const {
-    auto res = lower_bound_impl(value, node->left);
-    return res == nullptr ? end(node) : iterator(res);
+  // Same as locate(), but takes two comparisons if the value belongs right before the hint.
+  position locate(const value_t& value, iterator hint, node<Tag>* sentinel) const {
+    node<Tag>* next = hint.get_node();
+    if (next != sentinel && !compare(value, get_value(next))) {
+      return locate(value, sentinel);
+    }
+    const node<Tag>* prev = next->get_prev();
+    if (prev != sentinel && !compare(get_value(prev), value)) {
+      return locate(value, sentinel);
+    }
+    if (!next->left) {
+      return {next, true, next, false};
+    }
+    // The predecessor is the rightmost node of the left subtree here.
+    return {const_cast<node<Tag>*>(prev), false, next, false};
   }
 
-  const node<Tag>* lower_bound_impl(const value_t& value, const node<Tag>* node) const {
-    if (!node) {
-      return nullptr;
-    }
-    if (compare(static_cast<const node_t*>(node)->template get_value<Tag>(), value)) {
-      return lower_bound_impl(value, node->right);
-    } else {
-      auto res = lower_bound_impl(value, node->left);
-      if (res) {
-        return !compare(static_cast<const node_t*>(res)->template get_value<Tag>(), value) ? res : node;
+  template <typename K>
+  iterator lower_bound(const K& value, const node<Tag>* sentinel) const {
+    const node<Tag>* res = sentinel;
+    for (const node<Tag>* current = sentinel->left; current;) {
+      if (compare(get_value(current), value)) {
+        current = current->right;
       } else {
-        return node;
+        res = current;
+        current = current->left;
       }
     }
+    return iterator(res);
   }
 
-  iterator upper_bound(const value_t& value, const node<Tag>* node) const {
-    auto it = lower_bound(value, node);
-    if (it != end(node) && !compare(value, *it) && !compare(*it, value)) {
-      it++;
+  template <typename K>
+  iterator upper_bound(const K& value, const node<Tag>* sentinel) const {
+    const node<Tag>* res = sentinel;
+    for (const node<Tag>* current = sentinel->left; current;) {
+      if (compare(value, get_value(current))) {
+        res = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
     }
-    return it;
+    return iterator(res);
   }
 
-  iterator begin(const node<Tag>* node) const noexcept {
-    if (!node->left) {
-      return end(node);
-    }
-    return iterator(node->get_left(node->left));
+  iterator begin(const node<Tag>* sentinel) const noexcept {
+    return iterator(sentinel->get_next());
   }
 
   iterator end(const node<Tag>* node) const noexcept {
@@ -109,7 +135,11 @@ public:
   }
 
 private:
-  template <typename Left, typename Right, typename CompareLeft, typename CompareRight>
+  static const value_t& get_value(const node<Tag>* node) noexcept {
+    return static_cast<const node_t*>(node)->template get_value<Tag>();
+  }
+
+  template <typename Left, typename Right, typename CompareLeft, typename CompareRight, typename Allocator>
   friend class ::bimap;
 
   [[no_unique_address]] Compare compare;
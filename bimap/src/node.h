@@ -1,9 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
-#include <random>
+#include <utility>
 
-template <typename Left, typename Right, typename CompareLeft, typename CompareRight>
+template <typename Left, typename Right, typename CompareLeft, typename CompareRight, typename Allocator>
 class bimap;
 
 namespace bimap_impl {
@@ -24,56 +27,61 @@ public:
     if (right) {
       right->pred = this;
     }
+    take_list(other);
     clear_node(&other);
   }
 
-  const node* get_right(node* temp) const noexcept {
-    return !temp ? nullptr : (temp->right ? get_right(temp->right) : temp);
-  }
-
-  const node* get_left(node* temp) const noexcept {
-    return !temp ? nullptr : (temp->left ? get_left(temp->left) : temp);
-  }
-
+  // Nodes are threaded into a circular list in the in-order through the sentinel, so stepping
+  // takes constant time.
   const node* get_next() const noexcept {
-    auto res = get_left(right);
-    return res ? res : up_right(this);
+    return next;
   }
 
   const node* get_prev() const noexcept {
-    auto res = get_right(left);
-    return res ? res : up_left(this);
+    return prev;
   }
 
-  const node* up_right(const node* temp) const noexcept {
-    while (temp->pred && temp->pred->right == temp) {
-      temp = temp->pred;
-    }
-    return temp->pred ? temp->pred : temp;
-  }
-
-  const node* up_left(const node* temp) const noexcept {
-    while (temp->pred && temp->pred->left == temp) {
-      temp = temp->pred;
+  // Links a detached node as a child of this one and restores the heap order of priorities.
+  void attach(node* new_node, bool as_left) noexcept {
+    if (as_left) {
+      set_left(this, new_node);
+      link_list(prev, new_node, this);
+    } else {
+      set_right(this, new_node);
+      link_list(this, new_node, next);
     }
-    return temp->pred ? temp->pred : temp;
+    new_node->sift_up();
   }
 
-  void set_new_node(node* new_node) noexcept {
-    if (pred == nullptr || value > new_node->value) {
-      set_new_left(new_node);
+  // Links a detached node right before this one in the in-order.
+  void attach_before(node* new_node) noexcept {
+    if (!left) {
+      attach(new_node, true);
     } else {
-      set_new_right(new_node);
+      // The predecessor is the rightmost node of the left subtree.
+      prev->attach(new_node, false);
     }
   }
 
-  void set_new_left(node* new_node) noexcept {
-    if (left) {
-      new_node->left = left;
-      left->pred = new_node;
+  // Rotates the node up while its priority is greater than the parent's, the sentinel stays on top.
+  void sift_up() noexcept {
+    while (pred->pred && pred->value < value) {
+      node* parent = pred;
+      node* grandparent = parent->pred;
+      bool is_left = grandparent->left == parent;
+      if (parent->left == this) {
+        set_left(parent, right);
+        set_right(this, parent);
+      } else {
+        set_right(parent, left);
+        set_left(this, parent);
+      }
+      if (is_left) {
+        set_left(grandparent, this);
+      } else {
+        set_right(grandparent, this);
+      }
     }
-    new_node->pred = this;
-    left = new_node;
   }
 
   static void set_left(node* pred_, node* left_) noexcept {
@@ -96,68 +104,104 @@ public:
     node->right = nullptr;
   }
 
-  void set_pred(node* new_node) noexcept {
-    if (pred->left == this) {
-      set_left(pred, new_node);
-    } else {
-      set_right(pred, new_node);
+  // Replaces the node with the merge of its subtrees. The root with the greater priority takes the
+  // link, and the rest is merged into the link it leaves, so the merge walks down both spines in a loop.
+  void erase() noexcept {
+    node* parent = pred;
+    node** link = pred->left == this ? &pred->left : &pred->right;
+    node* lhs = left;
+    node* rhs = right;
+    while (lhs && rhs) {
+      if (lhs->value > rhs->value) {
+        *link = lhs;
+        lhs->pred = parent;
+        parent = lhs;
+        link = &lhs->right;
+        lhs = lhs->right;
+      } else {
+        *link = rhs;
+        rhs->pred = parent;
+        parent = rhs;
+        link = &rhs->left;
+        rhs = rhs->left;
+      }
     }
+    *link = lhs ? lhs : rhs;
+    if (*link) {
+      (*link)->pred = parent;
+    }
+    prev->next = next;
+    next->prev = prev;
+    clear_node(this);
   }
 
-  void set_new_right(node* new_node) noexcept {
-    if (left) {
-      set_left(new_node, left);
-      left = nullptr;
-    }
-    set_pred(new_node);
-    new_node->right = this;
-    pred = new_node;
+  // Swaps the trees of two sentinels.
+  friend void swap(node& lhs, node& rhs) noexcept {
+    auto lhs_left = lhs.left;
+    set_left(&lhs, rhs.left);
+    set_left(&rhs, lhs_left);
+    std::swap(lhs.next, rhs.next);
+    std::swap(lhs.prev, rhs.prev);
+    lhs.fix_list(&rhs);
+    rhs.fix_list(&lhs);
   }
 
-  void erase() noexcept {
-    auto* node = merge(left, right);
-    set_pred(node);
-    clear_node(this);
+  static void link_list(node* before, node* new_node, node* after) noexcept {
+    new_node->prev = before;
+    new_node->next = after;
+    before->next = new_node;
+    after->prev = new_node;
   }
 
-  node* merge(node* left, node* right) noexcept {
-    if (!left) {
-      return right;
-    }
-    if (!right) {
-      return left;
-    }
-    if (left->value > right->value) {
-      auto* res = merge(left->right, right);
-      set_right(left, res);
-      return left;
+  // Takes the place of another sentinel in its list, leaving it empty.
+  void take_list(node& other) noexcept {
+    if (other.next == &other) {
+      next = prev = this;
     } else {
-      auto* res = merge(left, right->left);
-      set_left(right, res);
-      return right;
+      next = other.next;
+      prev = other.prev;
+      next->prev = this;
+      prev->next = this;
     }
+    other.next = other.prev = &other;
   }
 
-  friend void swap(node& lhs, node& rhs) noexcept {
-    auto lhs_left = lhs.left;
-    set_left(&lhs, rhs.left);
-    set_left(&rhs, lhs_left);
+  // Makes the neighbours of a sentinel that got the list of `old_owner` point to it.
+  void fix_list(const node* old_owner) noexcept {
+    if (next == old_owner) {
+      next = prev = this;
+    } else {
+      next->prev = this;
+      prev->next = this;
+    }
   }
 
-  int random_int() noexcept {
-    static std::mt19937 generator(std::random_device{}());
-    std::uniform_int_distribution<int> distribution(0, INT_MAX);
-    return distribution(generator);
+  // Priorities come from a xorshift generator of the calling thread, so bimaps built on different
+  // threads share no state. Every thread starts from its own seed.
+  static int random_int() noexcept {
+    thread_local std::uint64_t state = seed();
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<int>(state >> 33);
   }
 
-  friend bool operator==(const node& lhs, const node& rhs) noexcept {
-    return lhs.pred == rhs.pred && lhs.left == rhs.left && lhs.right == rhs.right;
+  // Mixes a global counter with the clock by the splitmix64 finalizer, the result is never zero.
+  static std::uint64_t seed() noexcept {
+    static std::atomic<std::uint64_t> counter = 0;
+    std::uint64_t z = counter.fetch_add(0x9e3779b97f4a7c15, std::memory_order_relaxed) +
+                      static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return (z ^ (z >> 31)) | 1;
   }
 
   int value;
   node* left = nullptr;
   node* right = nullptr;
   node* pred = nullptr;
+  node* next = this;
+  node* prev = this;
 };
 
 class left_tag;
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace bimap_impl {
+// Allocates objects of one type from slabs that are taken from the allocator in growing batches.
+// Destroyed objects leave their slots in a free list, which is reused before the current slab.
+//
+// The slabs of a pool form its arena, which is given back to the allocator only when nothing refers
+// to it any more. A pool refers to its own arena and to the arenas it adopted from pools with an equal
+// allocator, so objects may be moved between such pools without being copied, and share() lets an
+// object outlive its pool. Only the pool that made an arena adds slabs to it.
+template <typename T, typename Allocator>
+class node_pool {
+  union slot;
+
+  struct slab_header {
+    slot* next;
+    std::size_t size;
+  };
+
+  union slot {
+    slot* next;
+    slab_header header;
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+  using traits = std::allocator_traits<slot_allocator>;
+
+  struct arena {
+    explicit arena(const slot_allocator& allocator) noexcept
+        : allocator(allocator) {}
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    ~arena() {
+      while (slabs) {
+        slot* slab = std::exchange(slabs, slabs->header.next);
+        traits::deallocate(allocator, slab, slab->header.size);
+      }
+    }
+
+    [[no_unique_address]] slot_allocator allocator;
+    slot* slabs = nullptr;
+  };
+
+  using arena_ptr = std::shared_ptr<arena>;
+  // Sorted by address and never changed once shared.
+  using arena_list =
+      std::vector<arena_ptr, typename std::allocator_traits<Allocator>::template rebind_alloc<arena_ptr>>;
+
+  static constexpr std::size_t min_slab_size = 8;
+  static constexpr std::size_t max_slab_size = std::max<std::size_t>(min_slab_size, (1 << 16) / sizeof(slot));
+
+public:
+  // Keeps the slabs of every object of a pool alive, even after the pool is gone.
+  using shared_slabs = std::shared_ptr<const arena_list>;
+
+  explicit node_pool(const Allocator& allocator) noexcept
+      : allocator_(allocator) {}
+
+  node_pool(node_pool&& other) noexcept
+      : allocator_(std::move(other.allocator_))
+      , arenas_(std::move(other.arenas_))
+      , own_(std::exchange(other.own_, nullptr))
+      , free_(std::exchange(other.free_, nullptr))
+      , current_(std::exchange(other.current_, nullptr))
+      , end_(std::exchange(other.end_, nullptr))
+      , slab_size_(std::exchange(other.slab_size_, min_slab_size)) {}
+
+  node_pool(const node_pool&) = delete;
+  node_pool& operator=(const node_pool&) = delete;
+  node_pool& operator=(node_pool&&) = delete;
+
+  // Objects still living in the slabs must have been destroyed or shared.
+  ~node_pool() = default;
+
+  friend void swap(node_pool& lhs, node_pool& rhs) noexcept {
+    using std::swap;
+    swap(lhs.allocator_, rhs.allocator_);
+    swap(lhs.arenas_, rhs.arenas_);
+    swap(lhs.own_, rhs.own_);
+    swap(lhs.free_, rhs.free_);
+    swap(lhs.current_, rhs.current_);
+    swap(lhs.end_, rhs.end_);
+    swap(lhs.slab_size_, rhs.slab_size_);
+  }
+
+  Allocator get_allocator() const noexcept {
+    return Allocator(allocator_);
+  }
+
+  template <typename... Args>
+  T* create(Args&&... args) {
+    slot* place = take();
+    try {
+      return ::new (static_cast<void*>(place->storage)) T(std::forward<Args>(args)...);
+    } catch (...) {
+      put(place);
+      throw;
+    }
+  }
+
+  void destroy(T* object) noexcept {
+    std::destroy_at(object);
+    put(reinterpret_cast<slot*>(object));
+  }
+
+  shared_slabs share() const noexcept {
+    return arenas_;
+  }
+
+  // Makes objects of the given slabs ours to keep and destroy. Returns false and changes nothing if
+  // they come from an allocator that is not equal to ours.
+  bool adopt(const shared_slabs& slabs) {
+    if (!slabs || slabs == arenas_) {
+      return true;
+    }
+    if (!(allocator_ == slabs->front()->allocator)) {
+      return false;
+    }
+    if (!arenas_) {
+      arenas_ = slabs;
+      return true;
+    }
+    if (std::includes(arenas_->begin(), arenas_->end(), slabs->begin(), slabs->end())) {
+      return true;
+    }
+    arena_list merged(allocator_);
+    merged.reserve(arenas_->size() + slabs->size());
+    std::set_union(arenas_->begin(), arenas_->end(), slabs->begin(), slabs->end(), std::back_inserter(merged));
+    arenas_ = std::allocate_shared<const arena_list>(allocator_, std::move(merged));
+    return true;
+  }
+
+private:
+  slot* take() {
+    if (free_) {
+      return std::exchange(free_, free_->next);
+    }
+    if (current_ == end_) {
+      if (!own_) {
+        make_arena();
+      }
+      // The first slot of a slab keeps the list of slabs.
+      slot* slab = std::to_address(traits::allocate(allocator_, slab_size_ + 1));
+      slab->header = {own_->slabs, slab_size_ + 1};
+      own_->slabs = slab;
+      current_ = slab + 1;
+      end_ = current_ + slab_size_;
+      slab_size_ = std::min(slab_size_ * 2, max_slab_size);
+    }
+    return current_++;
+  }
+
+  void make_arena() {
+    arena_ptr created = std::allocate_shared<arena>(allocator_, allocator_);
+    arena_list arenas(allocator_);
+    if (arenas_) {
+      arenas.reserve(arenas_->size() + 1);
+      arenas.assign(arenas_->begin(), arenas_->end());
+    }
+    arenas.insert(std::upper_bound(arenas.begin(), arenas.end(), created), created);
+    arenas_ = std::allocate_shared<const arena_list>(allocator_, std::move(arenas));
+    own_ = created.get();
+  }
+
+  void put(slot* place) noexcept {
+    place->next = free_;
+    free_ = place;
+  }
+
+  [[no_unique_address]] slot_allocator allocator_;
+  shared_slabs arenas_;
+  arena* own_ = nullptr;
+  slot* free_ = nullptr;
+  slot* current_ = nullptr;
+  slot* end_ = nullptr;
+  std::size_t slab_size_ = min_slab_size;
+};
+} // namespace bimap_impl
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace bimap_impl {
+// Tracks readers for read-copy-update. A reader counts itself in its stripe for the current phase,
+// and a writer that has unpublished an object waits in synchronize() until no reader can still see it.
+// Taking and dropping a read lock are a fixed number of steps, and threads mostly touch their own stripe.
+class rcu_domain {
+  static constexpr std::size_t stripes = 64;
+  static constexpr std::size_t cache_line = 64;
+
+public:
+  struct token {
+    std::size_t stripe;
+    std::size_t phase;
+  };
+
+  // The increment and the loads that follow it are sequentially consistent with the writer's
+  // publication and counter loads: a reader the writer doesn't count loads the new object.
+  token read_lock() noexcept {
+    token res = {stripe_index(), phase_.load() & 1};
+    counters_[res.stripe].readers[res.phase].fetch_add(1);
+    return res;
+  }
+
+  void read_unlock(token locked) noexcept {
+    counters_[locked.stripe].readers[locked.phase].fetch_sub(1, std::memory_order_release);
+  }
+
+  // Returns once every reader that started before the call has finished. A reader may read the phase
+  // before a flip and count itself in the old one only after the wait, so the phase is flipped twice.
+  void synchronize() noexcept {
+    flip_and_wait();
+    flip_and_wait();
+  }
+
+private:
+  struct alignas(cache_line) stripe {
+    std::atomic<std::size_t> readers[2] = {};
+  };
+
+  void flip_and_wait() noexcept {
+    std::size_t old_phase = phase_.fetch_add(1) & 1;
+    while (readers(old_phase) != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  std::size_t readers(std::size_t phase) const noexcept {
+    std::size_t res = 0;
+    for (const stripe& counter : counters_) {
+      res += counter.readers[phase].load();
+    }
+    return res;
+  }
+
+  // Threads take the stripes in turn, so the first threads never share one.
+  static std::size_t stripe_index() noexcept {
+    static std::atomic<std::size_t> next = 0;
+    thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % stripes;
+    return index;
+  }
+
+  std::atomic<std::size_t> phase_ = 0;
+  stripe counters_[stripes];
+};
+} // namespace bimap_impl
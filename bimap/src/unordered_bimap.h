@@ -0,0 +1,355 @@
+#pragma once
+
+#include "hash_index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bimap without the order of keys: every pair is stored once in an array and both sides are
+// open-addressing tables of positions in it, so lookups take constant time on average.
+// There are no lower_bound or upper_bound, and iteration follows the array.
+// Insertion invalidates references, erasure moves the last pair to the erased position, so it
+// invalidates iterators and references to the erased and the last pair. Keys must be nothrow movable.
+template <
+    typename Left,
+    typename Right,
+    typename HashLeft = std::hash<Left>,
+    typename HashRight = std::hash<Right>,
+    typename EqualLeft = std::equal_to<Left>,
+    typename EqualRight = std::equal_to<Right>>
+class unordered_bimap
+    : private bimap_impl::hash_index<bimap_impl::left_tag, HashLeft, EqualLeft>
+    , private bimap_impl::hash_index<bimap_impl::right_tag, HashRight, EqualRight> {
+public:
+  using left_t = Left;
+  using right_t = Right;
+  using left_iterator = bimap_impl::unordered_iterator<bimap_impl::left_tag, Left, Right>;
+  using right_iterator = bimap_impl::unordered_iterator<bimap_impl::right_tag, Right, Left>;
+  using left_index = bimap_impl::hash_index<bimap_impl::left_tag, HashLeft, EqualLeft>;
+  using right_index = bimap_impl::hash_index<bimap_impl::right_tag, HashRight, EqualRight>;
+  using element_t = bimap_impl::unordered_element<Left, Right>;
+
+  static_assert(
+      std::is_nothrow_move_constructible_v<Left> && std::is_nothrow_move_constructible_v<Right>,
+      "keys of an unordered_bimap must be nothrow movable"
+  );
+
+public:
+  unordered_bimap(
+      HashLeft hash_left = HashLeft(),
+      HashRight hash_right = HashRight(),
+      EqualLeft equal_left = EqualLeft(),
+      EqualRight equal_right = EqualRight()
+  )
+      : left_index(std::move(hash_left), std::move(equal_left))
+      , right_index(std::move(hash_right), std::move(equal_right)) {}
+
+  unordered_bimap(const unordered_bimap& other) = default;
+
+  unordered_bimap(unordered_bimap&& other) noexcept
+      : left_index(std::move(static_cast<left_index&>(other)))
+      , right_index(std::move(static_cast<right_index&>(other)))
+      , elements_(std::move(other.elements_)) {
+    other.elements_.clear();
+  }
+
+  unordered_bimap& operator=(const unordered_bimap& other) {
+    if (this != &other) {
+      *this = unordered_bimap(other);
+    }
+    return *this;
+  }
+
+  unordered_bimap& operator=(unordered_bimap&& other) noexcept {
+    if (this != &other) {
+      unordered_bimap tmp(std::move(other));
+      swap(tmp, *this);
+    }
+    return *this;
+  }
+
+  ~unordered_bimap() = default;
+
+  friend void swap(unordered_bimap& lhs, unordered_bimap& rhs) noexcept {
+    using std::swap;
+    swap(lhs.elements_, rhs.elements_);
+    swap(static_cast<left_index&>(lhs), static_cast<left_index&>(rhs));
+    swap(static_cast<right_index&>(lhs), static_cast<right_index&>(rhs));
+  }
+
+  left_iterator insert(const left_t& left, const right_t& right) {
+    return insert_impl(left, right);
+  }
+
+  left_iterator insert(const left_t& left, right_t&& right) {
+    return insert_impl(left, std::move(right));
+  }
+
+  left_iterator insert(left_t&& left, const right_t& right) {
+    return insert_impl(std::move(left), right);
+  }
+
+  left_iterator insert(left_t&& left, right_t&& right) {
+    return insert_impl(std::move(left), std::move(right));
+  }
+
+  // Returns the iterator to the pair that took the place of the erased one.
+  left_iterator erase_left(left_iterator it) noexcept {
+    erase_at(it.index_);
+    return it;
+  }
+
+  right_iterator erase_right(right_iterator it) noexcept {
+    erase_at(it.index_);
+    return it;
+  }
+
+  bool erase_left(const left_t& value) {
+    return erase_key<left_index>(value);
+  }
+
+  // The overloads taking any key type are available when both the hash and the equality of the side
+  // are transparent.
+  template <typename K>
+  bool erase_left(const K& value)
+    requires (bimap_impl::transparent_hash<HashLeft, EqualLeft>)
+  {
+    return erase_key<left_index>(value);
+  }
+
+  bool erase_right(const right_t& value) {
+    return erase_key<right_index>(value);
+  }
+
+  template <typename K>
+  bool erase_right(const K& value)
+    requires (bimap_impl::transparent_hash<HashRight, EqualRight>)
+  {
+    return erase_key<right_index>(value);
+  }
+
+  left_iterator find_left(const left_t& value) const {
+    return left_iterator(&elements_, index_of(find<left_index>(value)));
+  }
+
+  template <typename K>
+  left_iterator find_left(const K& value) const
+    requires (bimap_impl::transparent_hash<HashLeft, EqualLeft>)
+  {
+    return left_iterator(&elements_, index_of(find<left_index>(value)));
+  }
+
+  right_iterator find_right(const right_t& value) const {
+    return right_iterator(&elements_, index_of(find<right_index>(value)));
+  }
+
+  template <typename K>
+  right_iterator find_right(const K& value) const
+    requires (bimap_impl::transparent_hash<HashRight, EqualRight>)
+  {
+    return right_iterator(&elements_, index_of(find<right_index>(value)));
+  }
+
+  const right_t& at_left(const left_t& key) const {
+    return elements_[at<left_index>(key)].right;
+  }
+
+  template <typename K>
+  const right_t& at_left(const K& key) const
+    requires (bimap_impl::transparent_hash<HashLeft, EqualLeft>)
+  {
+    return elements_[at<left_index>(key)].right;
+  }
+
+  const left_t& at_right(const right_t& key) const {
+    return elements_[at<right_index>(key)].left;
+  }
+
+  template <typename K>
+  const left_t& at_right(const K& key) const
+    requires (bimap_impl::transparent_hash<HashRight, EqualRight>)
+  {
+    return elements_[at<right_index>(key)].left;
+  }
+
+  const right_t& at_left_or_default(const left_t& key)
+    requires (std::is_default_constructible_v<right_t>)
+  {
+    std::uint32_t left_hash = this->left_index::tag_of(key);
+    std::uint32_t position = this->left_index::find(key, left_hash, elements_);
+    if (position != left_index::npos) {
+      return elements_[position].right;
+    }
+    right_t default_value = right_t();
+    position = find<right_index>(default_value);
+    if (position == right_index::npos) {
+      return *insert_impl(key, std::move(default_value)).flip();
+    }
+    // The pair with the default value gets the new left key.
+    left_t new_key(key);
+    element_t& element = elements_[position];
+    this->left_index::erase(element.left_hash, position);
+    std::destroy_at(&element.left);
+    std::construct_at(&element.left, std::move(new_key));
+    element.left_hash = left_hash;
+    this->left_index::insert(left_hash, position);
+    return element.right;
+  }
+
+  const left_t& at_right_or_default(const right_t& key)
+    requires (std::is_default_constructible_v<left_t>)
+  {
+    std::uint32_t right_hash = this->right_index::tag_of(key);
+    std::uint32_t position = this->right_index::find(key, right_hash, elements_);
+    if (position != right_index::npos) {
+      return elements_[position].left;
+    }
+    left_t default_value = left_t();
+    position = find<left_index>(default_value);
+    if (position == left_index::npos) {
+      return *insert_impl(std::move(default_value), key);
+    }
+    // The pair with the default value gets the new right key.
+    right_t new_key(key);
+    element_t& element = elements_[position];
+    this->right_index::erase(element.right_hash, position);
+    std::destroy_at(&element.right);
+    std::construct_at(&element.right, std::move(new_key));
+    element.right_hash = right_hash;
+    this->right_index::insert(right_hash, position);
+    return element.left;
+  }
+
+  // Makes room for `count` pairs, so that inserting them doesn't grow the array and the tables.
+  void reserve(std::size_t count) {
+    if (count > left_index::max_size) {
+      throw std::length_error("unordered_bimap is too large");
+    }
+    elements_.reserve(count);
+    this->left_index::reserve(count);
+    this->right_index::reserve(count);
+  }
+
+  left_iterator begin_left() const noexcept {
+    return left_iterator(&elements_, 0);
+  }
+
+  left_iterator end_left() const noexcept {
+    return left_iterator(&elements_, elements_.size());
+  }
+
+  right_iterator begin_right() const noexcept {
+    return right_iterator(&elements_, 0);
+  }
+
+  right_iterator end_right() const noexcept {
+    return right_iterator(&elements_, elements_.size());
+  }
+
+  bool empty() const noexcept {
+    return elements_.empty();
+  }
+
+  std::size_t size() const noexcept {
+    return elements_.size();
+  }
+
+  friend bool operator==(const unordered_bimap& lhs, const unordered_bimap& rhs) {
+    if (lhs.size() != rhs.size()) {
+      return false;
+    }
+    for (const element_t& element : lhs.elements_) {
+      std::uint32_t position = rhs.find<left_index>(element.left);
+      if (position == left_index::npos || !rhs.equal_right()(element.right, rhs.elements_[position].right)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  friend bool operator!=(const unordered_bimap& lhs, const unordered_bimap& rhs) {
+    return !(lhs == rhs);
+  }
+
+private:
+  const EqualRight& equal_right() const noexcept {
+    return static_cast<const right_index&>(*this).equal;
+  }
+
+  // Missing keys are found at the end of the array.
+  std::size_t index_of(std::uint32_t position) const noexcept {
+    return position == left_index::npos ? size() : position;
+  }
+
+  template <typename Index, typename K>
+  std::uint32_t find(const K& key) const {
+    return this->Index::find(key, this->Index::tag_of(key), elements_);
+  }
+
+  template <typename Index, typename K>
+  std::uint32_t at(const K& key) const {
+    std::uint32_t position = find<Index>(key);
+    if (position == Index::npos) {
+      throw std::out_of_range("Index is out of range");
+    }
+    return position;
+  }
+
+  template <typename Index, typename K>
+  bool erase_key(const K& key) {
+    std::uint32_t position = find<Index>(key);
+    if (position == Index::npos) {
+      return false;
+    }
+    erase_at(position);
+    return true;
+  }
+
+  template <typename Left_t, typename Right_t>
+  left_iterator insert_impl(Left_t&& left, Right_t&& right) {
+    std::uint32_t left_hash = this->left_index::tag_of(left);
+    if (this->left_index::find(left, left_hash, elements_) != left_index::npos) {
+      return end_left();
+    }
+    std::uint32_t right_hash = this->right_index::tag_of(right);
+    if (this->right_index::find(right, right_hash, elements_) != right_index::npos) {
+      return end_left();
+    }
+    if (size() == left_index::max_size) {
+      throw std::length_error("unordered_bimap is too large");
+    }
+    // Nothing is linked until the pair is in the array, so a throwing constructor leaves the tables intact.
+    this->left_index::reserve(size() + 1);
+    this->right_index::reserve(size() + 1);
+    elements_.emplace_back(std::forward<Left_t>(left), std::forward<Right_t>(right), left_hash, right_hash);
+    auto position = static_cast<std::uint32_t>(elements_.size() - 1);
+    this->left_index::insert(left_hash, position);
+    this->right_index::insert(right_hash, position);
+    return left_iterator(&elements_, position);
+  }
+
+  // Removes the pair at the position and moves the last pair to its place.
+  void erase_at(std::size_t index) noexcept {
+    auto position = static_cast<std::uint32_t>(index);
+    auto last = static_cast<std::uint32_t>(elements_.size() - 1);
+    element_t& erased = elements_[position];
+    this->left_index::erase(erased.left_hash, position);
+    this->right_index::erase(erased.right_hash, position);
+    if (position != last) {
+      element_t& moved = elements_[last];
+      this->left_index::relink(moved.left_hash, last, position);
+      this->right_index::relink(moved.right_hash, last, position);
+      std::destroy_at(&erased);
+      std::construct_at(&erased, std::move(moved));
+    }
+    elements_.pop_back();
+  }
+
+  std::vector<element_t> elements_;
+};
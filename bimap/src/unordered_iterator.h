@@ -0,0 +1,118 @@
+#pragma once
+
+#include "bimap_iterator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+template <
+    typename Left,
+    typename Right,
+    typename HashLeft,
+    typename HashRight,
+    typename EqualLeft,
+    typename EqualRight>
+class unordered_bimap;
+
+namespace bimap_impl {
+// A pair of an unordered_bimap with the hashes of its keys, as the tables of both sides keep them.
+template <typename Left, typename Right>
+struct unordered_element {
+  template <typename Tag>
+  const auto& key() const noexcept {
+    if constexpr (std::is_same_v<Tag, left_tag>) {
+      return left;
+    } else {
+      return right;
+    }
+  }
+
+  Left left;
+  Right right;
+  std::uint32_t left_hash;
+  std::uint32_t right_hash;
+};
+
+// Iterator over one side of an unordered_bimap. Both sides walk the same element array in the same
+// order, so flipping keeps the position.
+template <typename Tag, typename Current, typename Another>
+class unordered_iterator {
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = Current;
+  using reference = const Current&;
+  using pointer = const Current*;
+
+  unordered_iterator() noexcept = default;
+
+  reference operator*() const noexcept {
+    return (*elements_)[index_].template key<Tag>();
+  }
+
+  pointer operator->() const noexcept {
+    return &**this;
+  }
+
+  unordered_iterator& operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+
+  unordered_iterator operator++(int) noexcept {
+    unordered_iterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  unordered_iterator& operator--() noexcept {
+    --index_;
+    return *this;
+  }
+
+  unordered_iterator operator--(int) noexcept {
+    unordered_iterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  unordered_iterator<typename opposite_tag<Tag>::type, Another, Current> flip() const noexcept {
+    return {elements_, index_};
+  }
+
+  friend bool operator==(const unordered_iterator& lhs, const unordered_iterator& rhs) noexcept {
+    return lhs.index_ == rhs.index_;
+  }
+
+  friend bool operator!=(const unordered_iterator& lhs, const unordered_iterator& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+private:
+  using element_t = std::conditional_t<
+      std::is_same_v<Tag, left_tag>,
+      unordered_element<Current, Another>,
+      unordered_element<Another, Current>>;
+
+  unordered_iterator(const std::vector<element_t>* elements, std::size_t index) noexcept
+      : elements_(elements)
+      , index_(index) {}
+
+  template <typename Tag2, typename Current2, typename Another2>
+  friend class unordered_iterator;
+  template <
+      typename Left,
+      typename Right,
+      typename HashLeft,
+      typename HashRight,
+      typename EqualLeft,
+      typename EqualRight>
+  friend class ::unordered_bimap;
+
+  const std::vector<element_t>* elements_ = nullptr;
+  std::size_t index_ = 0;
+};
+} // namespace bimap_impl
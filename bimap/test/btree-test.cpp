@@ -0,0 +1,259 @@
+#include "btree_bimap.h"
+#include "test-classes.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+template class btree_bimap<int, non_default_constructible>;
+template class btree_bimap<non_default_constructible, int>;
+
+namespace {
+
+template <typename Bimap, typename Left, typename Right>
+void check_contents(const Bimap& b, const std::map<Left, Right>& left, const std::map<Right, Left>& right) {
+  REQUIRE(b.size() == left.size());
+
+  auto it = b.begin_left();
+  for (const auto& [key, value] : left) {
+    REQUIRE(it != b.end_left());
+    REQUIRE(*it == key);
+    REQUIRE(*it.flip() == value);
+    REQUIRE(it.flip().flip() == it);
+    ++it;
+  }
+  REQUIRE(it == b.end_left());
+
+  auto rit = b.end_right();
+  for (auto ref = right.rbegin(); ref != right.rend(); ++ref) {
+    --rit;
+    REQUIRE(*rit == ref->first);
+    REQUIRE(*rit.flip() == ref->second);
+  }
+  REQUIRE(rit == b.begin_right());
+}
+
+// Random operations against a pair of std::map, keys are small enough to be erased often.
+template <typename Left, typename Right, typename Make>
+void run_random_operations(Make make_left, std::size_t total) {
+  btree_bimap<Left, Right> b;
+  std::map<Left, Right> left;
+  std::map<Right, Left> right;
+
+  std::mt19937 e(1488228);
+  for (std::size_t i = 0; i < total; i++) {
+    auto op = e() % 10;
+    Left l = make_left(e() % 5000);
+    Right r = static_cast<Right>(e() % 5000);
+    if (op < 6) {
+      bool inserted = !left.contains(l) && !right.contains(r);
+      auto it = b.insert(l, r);
+      REQUIRE((it != b.end_left()) == inserted);
+      if (inserted) {
+        REQUIRE(*it == l);
+        REQUIRE(*it.flip() == r);
+        left.emplace(l, r);
+        right.emplace(r, l);
+      }
+    } else if (op < 8) {
+      auto it = b.lower_bound_left(l);
+      auto ref = left.lower_bound(l);
+      if (ref == left.end()) {
+        REQUIRE(it == b.end_left());
+        continue;
+      }
+      REQUIRE(*it == ref->first);
+      auto next = b.erase_left(it);
+      right.erase(ref->second);
+      ref = left.erase(ref);
+      REQUIRE((next == b.end_left()) == (ref == left.end()));
+      if (ref != left.end()) {
+        REQUIRE(*next == ref->first);
+      }
+    } else {
+      bool erased = right.contains(r);
+      REQUIRE(b.erase_right(r) == erased);
+      if (erased) {
+        left.erase(right.at(r));
+        right.erase(r);
+      }
+    }
+    if (i % 1000 == 0) {
+      check_contents(b, left, right);
+    }
+  }
+  check_contents(b, left, right);
+}
+
+} // namespace
+
+TEST_CASE("B-tree: simple") {
+  btree_bimap<int, int> b;
+  b.insert(4, 4);
+  CHECK(b.at_left(4) == 4);
+  CHECK(b.at_right(4) == 4);
+  CHECK_THROWS_AS(b.at_left(1), std::out_of_range);
+  CHECK_THROWS_AS(b.at_right(300), std::out_of_range);
+}
+
+TEST_CASE("B-tree: insert existing") {
+  btree_bimap<int, int> b;
+  b.insert(1, 2);
+  b.insert(2, 3);
+  b.insert(3, 4);
+
+  CHECK(b.insert(2, -1) == b.end_left());
+  CHECK(b.insert(-1, 2) == b.end_left());
+  CHECK(b.size() == 3);
+  CHECK(b.at_left(2) == 3);
+  CHECK(b.at_right(2) == 1);
+}
+
+TEST_CASE("B-tree: move-only keys") {
+  btree_bimap<test_object, test_object> b;
+  for (int i = 0; i < 1000; i++) {
+    test_object left(i), right(-i);
+    b.insert(std::move(left), std::move(right));
+    CHECK(left.a == 0);
+  }
+
+  CHECK(b.size() == 1000);
+  CHECK(b.find_left(test_object(500)).flip()->a == -500);
+  CHECK(b.lower_bound_right(test_object(-1)).flip()->a == 1);
+  CHECK(b.upper_bound_left(test_object(998))->a == 999);
+  CHECK(b.erase_right(test_object(-10)));
+  CHECK(b.find_left(test_object(10)) == b.end_left());
+}
+
+TEST_CASE("B-tree: flip end iterator") {
+  btree_bimap<int, int, state_comparator, state_comparator> b;
+  CHECK(b.end_left().flip() == b.end_right());
+  CHECK(b.end_right().flip() == b.end_left());
+
+  for (int i = 0; i < 500; i++) {
+    b.insert(i, 1000 - i);
+  }
+
+  CHECK(b.end_left().flip() == b.end_right());
+  CHECK(b.end_right().flip() == b.end_left());
+  CHECK(*--b.end_left() == 499);
+  CHECK(*--b.end_right() == 1000);
+}
+
+TEST_CASE("B-tree: custom comparator") {
+  btree_bimap<int, int, std::greater<>> b;
+  for (int i = 0; i < 300; i++) {
+    b.insert(i * 7 % 300, i);
+  }
+
+  CHECK(std::is_sorted(b.begin_left(), b.end_left(), std::greater<>()));
+  CHECK(std::is_sorted(b.begin_right(), b.end_right()));
+  CHECK(*b.lower_bound_left(150) == 150);
+  CHECK(*b.upper_bound_left(150) == 149);
+}
+
+TEST_CASE("B-tree: at-or-default") {
+  btree_bimap<int, int> b;
+  b.insert(4, 2);
+
+  CHECK(b.at_left_or_default(4) == 2);
+  CHECK(b.at_right_or_default(2) == 4);
+
+  CHECK(b.at_left_or_default(5) == 0);
+  CHECK(b.at_right(0) == 5);
+
+  CHECK(b.at_right_or_default(1) == 0);
+  CHECK(b.at_left(0) == 1);
+
+  CHECK(b.at_left_or_default(42) == 0); // (5, 0) is replaced with (42, 0)
+  CHECK(b.at_right(0) == 42);
+  CHECK(b.at_left(42) == 0);
+
+  CHECK(b.at_right_or_default(1000) == 0); // (0, 1) is replaced with (0, 1000)
+  CHECK(b.at_left(0) == 1000);
+  CHECK(b.at_right(1000) == 0);
+}
+
+TEST_CASE("B-tree: erase range") {
+  btree_bimap<int, int> b;
+  for (int i = 0; i < 1000; i++) {
+    b.insert(i, -i);
+  }
+
+  auto it = b.erase_left(b.find_left(100), b.find_left(900));
+  CHECK(*it == 900);
+  CHECK(b.size() == 200);
+
+  auto rit = b.erase_right(b.find_right(-50), b.end_right());
+  CHECK(rit == b.end_right());
+  CHECK(b.size() == 149);
+  CHECK(*b.begin_left() == 51);
+
+  b.erase_left(b.begin_left(), b.end_left());
+  CHECK(b.empty());
+  CHECK(b.begin_right() == b.end_right());
+}
+
+TEST_CASE("B-tree: copy, move and swap") {
+  btree_bimap<int, int> b;
+  for (int i = 0; i < 1000; i++) {
+    b.insert(i, i * 3 % 1000);
+  }
+
+  btree_bimap<int, int> copy = b;
+  CHECK(copy == b);
+
+  copy.erase_left(7);
+  CHECK(copy != b);
+
+  btree_bimap<int, int> moved = std::move(b);
+  CHECK(moved.size() == 1000);
+  CHECK(moved.at_right(21) == 7);
+
+  swap(moved, copy);
+  CHECK(moved.size() == 999);
+  CHECK(copy.size() == 1000);
+
+  copy = moved;
+  CHECK(copy == moved);
+}
+
+TEST_CASE("B-tree: move with expiring comparator") {
+  using bimap = btree_bimap<int, int, expiring_comparator, expiring_comparator>;
+
+  bimap a;
+  a.insert(1, 4);
+  a.insert(8, 8);
+  a.insert(25, 17);
+  a.insert(13, 37);
+
+  bimap a_copy = a;
+  bimap b = std::move(a);
+  CHECK(b == a_copy);
+}
+
+TEST_CASE("B-tree: iterator traits") {
+  using bm = btree_bimap<int, double>;
+  STATIC_CHECK(std::bidirectional_iterator<bm::left_iterator>);
+  STATIC_CHECK(std::bidirectional_iterator<bm::right_iterator>);
+  STATIC_CHECK(std::is_same_v<std::iterator_traits<bm::left_iterator>::reference, const int&>);
+  STATIC_CHECK(std::is_same_v<std::iterator_traits<bm::right_iterator>::reference, const double&>);
+}
+
+TEST_CASE("[Randomized] - B-tree against std::map") {
+  run_random_operations<int, int>([](unsigned value) { return static_cast<int>(value); }, 200'000);
+}
+
+TEST_CASE("[Randomized] - B-tree with small nodes") {
+  using key = std::array<int, 16>;
+  run_random_operations<key, unsigned>([](unsigned value) { return key{static_cast<int>(value)}; }, 50'000);
+}
+
+TEST_CASE("[Randomized] - B-tree with strings") {
+  run_random_operations<std::string, int>([](unsigned value) { return std::to_string(value); }, 50'000);
+}
@@ -0,0 +1,120 @@
+#include "concurrent_bimap.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+template class concurrent_bimap<int, std::string>;
+
+TEST_CASE("Concurrent bimap single changes") {
+  concurrent_bimap<int, std::string> b;
+  CHECK(b.read()->empty());
+
+  CHECK(b.insert(1, "one"));
+  CHECK(b.insert(2, "two"));
+  CHECK_FALSE(b.insert(1, "three"));
+  CHECK_FALSE(b.insert(3, "two"));
+  CHECK(b.read()->size() == 2);
+  CHECK(b.read()->at_left(1) == "one");
+  CHECK(b.read()->at_right("two") == 2);
+
+  CHECK(b.erase_left(1));
+  CHECK_FALSE(b.erase_left(1));
+  CHECK(b.erase_right("two"));
+  CHECK_FALSE(b.erase_right("two"));
+  CHECK(b.read()->empty());
+}
+
+TEST_CASE("Concurrent bimap update") {
+  concurrent_bimap<int, int> b;
+  b.update([](auto& next) {
+    for (int i = 0; i < 100; i++) {
+      next.insert(i, -i);
+    }
+  });
+  CHECK(b.read()->size() == 100);
+
+  CHECK_THROWS_AS(
+      b.update([](auto& next) {
+        next.erase_left(0);
+        throw std::runtime_error("failed update");
+      }),
+      std::runtime_error
+  );
+  CHECK(b.read()->size() == 100);
+  CHECK(b.read()->at_left(0) == 0);
+
+  bimap<int, int> replacement;
+  replacement.insert(5, 6);
+  b.assign(std::move(replacement));
+  auto snapshot = b.read();
+  CHECK(snapshot->size() == 1);
+  CHECK(snapshot->at_left(5) == 6);
+}
+
+TEST_CASE("Concurrent bimap snapshot outlives its version") {
+  concurrent_bimap<int, int> b;
+  b.insert(1, 1);
+
+  auto old = b.read();
+  std::thread writer([&] { b.insert(2, 2); });
+  // The writer publishes first and then waits for the old snapshot.
+  while (b.read()->size() != 2) {
+    std::this_thread::yield();
+  }
+  CHECK(old->size() == 1);
+  CHECK(old->find_left(2) == old->end_left());
+  {
+    auto dropped = std::move(old);
+  }
+  writer.join();
+  CHECK(b.read()->at_right(2) == 2);
+}
+
+TEST_CASE("Concurrent bimap readers see whole versions") {
+  static constexpr int versions = 200;
+  static constexpr int batch = 20;
+  concurrent_bimap<int, int> b;
+  std::atomic<bool> done = false;
+  std::atomic<std::size_t> failures = 0;
+
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&] {
+      std::size_t last_size = 0;
+      while (!done.load()) {
+        auto snapshot = b.read();
+        // Every version holds the keys 0, 1, ... size - 1, each paired with its negation.
+        std::size_t size = snapshot->size();
+        bool consistent = size % batch == 0 && size >= last_size;
+        int expected = 0;
+        for (auto it = snapshot->begin_left(); it != snapshot->end_left(); ++it, ++expected) {
+          consistent &= *it == expected && *it.flip() == -expected;
+        }
+        consistent &= static_cast<std::size_t>(expected) == size;
+        if (!consistent) {
+          failures++;
+        }
+        last_size = size;
+      }
+    });
+  }
+
+  for (int v = 0; v < versions; v++) {
+    b.update([v](auto& next) {
+      for (int i = v * batch; i < (v + 1) * batch; i++) {
+        next.insert(i, -i);
+      }
+    });
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  CHECK(failures == 0);
+  CHECK(b.read()->size() == versions * batch);
+}
@@ -4,7 +4,12 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 template class bimap<int, non_default_constructible>;
 template class bimap<non_default_constructible, int>;
@@ -216,6 +221,149 @@ TEST_CASE("Insert xvalue") {
   }
 }
 
+TEST_CASE("Insert with hint") {
+  bimap<int, int> b;
+  for (int i = 0; i < 1000; i++) {
+    auto it = b.insert(b.end_left(), b.end_right(), i, -i);
+    CHECK(*it == i);
+  }
+  CHECK(b.size() == 1000);
+  CHECK(std::is_sorted(b.begin_left(), b.end_left()));
+  CHECK(std::is_sorted(b.begin_right(), b.end_right()));
+
+  SECTION("Exact hint") {
+    b.erase_left(500);
+    auto it = b.insert(b.find_left(501), b.find_right(-499), 500, -500);
+    CHECK(*it.flip() == -500);
+    CHECK(b.at_right(-500) == 500);
+    CHECK(std::next(it) == b.find_left(501));
+  }
+
+  SECTION("Wrong hint") {
+    auto it = b.insert(b.begin_left(), b.end_right(), 2000, 2000);
+    CHECK(*it == 2000);
+    CHECK(std::prev(b.end_left()) == it);
+    CHECK(b.find_right(2000).flip() == it);
+  }
+
+  SECTION("Existing") {
+    CHECK(b.insert(b.find_left(10), b.find_right(-10), 10, 5) == b.end_left());
+    CHECK(b.insert(b.find_left(11), b.find_right(-9), 10, 5) == b.end_left());
+    CHECK(b.insert(b.end_left(), b.find_right(-5), 5000, -5) == b.end_left());
+    CHECK(b.size() == 1000);
+  }
+}
+
+TEST_CASE("Sorted insert stays balanced") {
+  static constexpr int N = 200'000;
+  bimap<int, int> b;
+  for (int i = 0; i < N; i++) {
+    b.insert(i, N - i);
+  }
+  for (int i = 0; i < N; i += 7) {
+    CHECK(b.at_left(i) == N - i);
+  }
+}
+
+TEST_CASE("Range constructor") {
+  SECTION("Sorted") {
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < 1000; i++) {
+      pairs.emplace_back(i, i * 7 % 1000);
+    }
+    bimap<int, int> b(pairs.begin(), pairs.end());
+    CHECK(b.size() == 1000);
+    CHECK(std::is_sorted(b.begin_left(), b.end_left()));
+    CHECK(std::is_sorted(b.begin_right(), b.end_right()));
+    for (const auto& [left, right] : pairs) {
+      CHECK(b.at_left(left) == right);
+      CHECK(b.at_right(right) == left);
+    }
+  }
+
+  SECTION("Unsorted") {
+    std::vector<std::pair<int, int>> pairs = {{5, 1}, {3, 2}, {9, 3}, {1, 4}};
+    bimap<int, int, std::greater<>> b(pairs.begin(), pairs.end());
+    CHECK(std::is_sorted(b.begin_left(), b.end_left(), std::greater<>()));
+    CHECK(*b.begin_left() == 9);
+    CHECK(b.at_right(4) == 1);
+  }
+
+  SECTION("Duplicate keys") {
+    std::vector<std::pair<int, int>> pairs = {{1, 1}, {2, 2}, {2, 3}, {3, 1}, {4, 4}};
+    bimap<int, int> b(pairs.begin(), pairs.end());
+    CHECK(b.size() == 3);
+    CHECK(b.at_left(4) == 4);
+    CHECK(std::is_sorted(b.begin_right(), b.end_right()));
+    for (auto it = b.begin_left(); it != b.end_left(); ++it) {
+      CHECK(b.at_right(*it.flip()) == *it);
+    }
+  }
+
+  SECTION("Move-only keys") {
+    std::vector<std::pair<test_object, test_object>> pairs;
+    pairs.emplace_back(test_object(1), test_object(2));
+    pairs.emplace_back(test_object(3), test_object(4));
+    bimap<test_object, test_object> b(std::make_move_iterator(pairs.begin()), std::make_move_iterator(pairs.end()));
+    CHECK(pairs[0].first.a == 0);
+    CHECK(b.at_left(test_object(3)).a == 4);
+  }
+
+  SECTION("Empty") {
+    std::vector<std::pair<int, int>> pairs;
+    bimap<int, int> b(pairs.begin(), pairs.end());
+    CHECK(b.empty());
+    CHECK(b.begin_left() == b.end_left());
+  }
+}
+
+TEST_CASE("Assign") {
+  bimap<int, int> b;
+  b.insert(100, 100);
+
+  std::vector<std::pair<int, int>> pairs = {{1, 3}, {2, 2}, {3, 1}};
+  b.assign(pairs.begin(), pairs.end());
+  CHECK(b.size() == 3);
+  CHECK(b.find_left(100) == b.end_left());
+  CHECK(b.at_left(1) == 3);
+  CHECK(*b.begin_right().flip() == 3);
+}
+
+TEST_CASE("Custom allocator") {
+  using allocator = counting_allocator<std::pair<int, std::string>>;
+  using bimap_t = bimap<int, std::string, std::less<int>, std::less<std::string>, allocator>;
+
+  allocation_stats stats;
+  {
+    bimap_t b({}, {}, allocator(&stats));
+    CHECK(b.get_allocator().stats == &stats);
+    for (int i = 0; i < 1000; i++) {
+      b.insert(i, std::to_string(i) + " is long enough to be allocated");
+    }
+    // Nodes come from slabs, so there are far fewer allocations than nodes.
+    std::size_t allocations = stats.allocations;
+    CHECK(allocations < 100);
+
+    for (int i = 0; i < 1000; i += 2) {
+      b.erase_left(i);
+    }
+    for (int i = 0; i < 500; i++) {
+      b.insert(-i - 1, std::to_string(-i));
+    }
+    CHECK(stats.allocations == allocations);
+    CHECK(b.size() == 1000);
+
+    bimap_t copy = b;
+    CHECK(copy.get_allocator().stats == &stats);
+    CHECK(copy == b);
+
+    bimap_t moved = std::move(copy);
+    CHECK(moved == b);
+  }
+  CHECK(stats.allocations == stats.deallocations);
+  CHECK(stats.allocated_bytes == 0);
+}
+
 TEST_CASE("At") {
   bimap<int, int> b;
   b.insert(4, 3);
@@ -226,6 +374,33 @@ TEST_CASE("At") {
   CHECK(b.at_right(3) == 4);
 }
 
+TEST_CASE("Transparent lookup") {
+  // std::string_view doesn't convert to std::string implicitly, so these calls compile only with
+  // the overloads for transparent comparators.
+  bimap<std::string, std::string, std::less<>, std::less<>> b;
+  b.insert("apple", "red");
+  b.insert("banana", "yellow");
+  b.insert("cherry", "dark red");
+
+  std::string_view banana = "banana";
+  CHECK(*b.find_left(banana).flip() == "yellow");
+  CHECK(b.find_right(std::string_view("green")) == b.end_right());
+  CHECK(b.at_left(std::string_view("apple")) == "red");
+  CHECK(b.at_right(std::string_view("dark red")) == "cherry");
+  CHECK_THROWS_AS(b.at_left(std::string_view("durian")), std::out_of_range);
+
+  CHECK(*b.lower_bound_left(std::string_view("b")) == "banana");
+  CHECK(*b.upper_bound_left(banana) == "cherry");
+  CHECK(*b.lower_bound_right(std::string_view("red")) == "red");
+  CHECK(b.upper_bound_right(std::string_view("yellow")) == b.end_right());
+
+  CHECK(b.erase_left(banana));
+  CHECK_FALSE(b.erase_left(banana));
+  CHECK(b.erase_right(std::string_view("red")));
+  CHECK(b.size() == 1);
+  CHECK(*b.begin_left() == "cherry");
+}
+
 TEST_CASE("At-or-default") {
   bimap<int, int> b;
   b.insert(4, 2);
@@ -399,6 +574,191 @@ TEST_CASE("Erase range") {
   CHECK(b.empty());
 }
 
+TEST_CASE("Extract and insert node") {
+  bimap<int, test_object> b;
+  for (int i = 0; i < 10; i++) {
+    b.insert(i, test_object(-i));
+  }
+  const test_object* address = &*b.find_left(4).flip();
+
+  auto node = b.extract(b.find_left(4));
+  CHECK(!node.empty());
+  CHECK(node.left() == 4);
+  CHECK(node.right().a == -4);
+  CHECK(b.size() == 9);
+  CHECK(b.find_left(4) == b.end_left());
+  CHECK(b.find_right(test_object(-4)) == b.end_right());
+
+  node.left() = 40;
+  auto it = b.insert(std::move(node));
+  CHECK(node.empty());
+  CHECK(*it == 40);
+  CHECK(&*it.flip() == address);
+  CHECK(b.size() == 10);
+  CHECK(std::is_sorted(b.begin_left(), b.end_left()));
+  CHECK(std::is_sorted(b.begin_right(), b.end_right()));
+
+  SECTION("Right iterator") {
+    auto right_node = b.extract(b.find_right(test_object(-7)));
+    CHECK(right_node.left() == 7);
+    CHECK(b.size() == 9);
+    CHECK(b.insert(std::move(right_node)) != b.end_left());
+    CHECK(b.at_left(7).a == -7);
+  }
+
+  SECTION("Taken key") {
+    auto taken = b.extract(b.find_left(5));
+    taken.left() = 6;
+    CHECK(b.insert(std::move(taken)) == b.end_left());
+    CHECK(!taken.empty());
+    CHECK(b.size() == 9);
+  }
+
+  SECTION("Empty handle") {
+    decltype(b)::node_type empty;
+    CHECK(!empty);
+    CHECK(b.insert(std::move(empty)) == b.end_left());
+    CHECK(b.size() == 10);
+  }
+}
+
+TEST_CASE("Insert node from another bimap") {
+  bimap<test_object, test_object> a;
+  bimap<test_object, test_object> b;
+  a.insert(test_object(1), test_object(2));
+  a.insert(test_object(3), test_object(4));
+  b.insert(test_object(5), test_object(6));
+
+  const test_object* address = &*a.find_left(test_object(1));
+
+  auto it = b.insert(a.extract(a.find_left(test_object(1))));
+  CHECK(it->a == 1);
+  CHECK(it.flip()->a == 2);
+  CHECK(&*it == address);
+  CHECK(a.size() == 1);
+  CHECK(b.size() == 2);
+  CHECK(b.at_right(test_object(2)).a == 1);
+}
+
+TEST_CASE("Node handle outlives its bimap") {
+  using bimap_t = bimap<int, std::string>;
+  auto a = std::make_unique<bimap_t>();
+  for (int i = 0; i < 10; i++) {
+    a->insert(i, std::to_string(i) + " is long enough to be allocated");
+  }
+  auto kept = a->extract(a->find_left(1));
+  auto dropped = a->extract(a->find_left(2));
+  const std::string* address = &kept.right();
+
+  bimap_t other;
+  other.insert(100, "100");
+  SECTION("Move assignment") {
+    *a = std::move(other);
+  }
+  SECTION("Copy assignment") {
+    *a = other;
+  }
+  SECTION("Assign") {
+    std::vector<std::pair<int, std::string>> pairs = {{5, "5"}};
+    a->assign(pairs.begin(), pairs.end());
+  }
+  SECTION("Destruction") {
+    a.reset();
+  }
+  SECTION("Swap") {
+    swap(*a, other);
+  }
+
+  dropped = {};
+  CHECK(dropped.empty());
+
+  bimap_t b;
+  auto it = b.insert(std::move(kept));
+  CHECK(kept.empty());
+  CHECK(*it == 1);
+  CHECK(&*it.flip() == address);
+  CHECK(*it.flip() == "1 is long enough to be allocated");
+  a.reset();
+  other = bimap_t();
+  b.insert(2, "2 is long enough to be allocated");
+  CHECK(b.size() == 2);
+}
+
+TEST_CASE("Merge") {
+  bimap<int, std::string> a;
+  bimap<int, std::string> b;
+  for (int i = 0; i < 100; i++) {
+    a.insert(i, std::to_string(i) + " is long enough to be allocated");
+  }
+  for (int i = 50; i < 150; i += 2) {
+    b.insert(i, std::to_string(i) + " is long enough to be allocated");
+  }
+  b.insert(1000, "0 is long enough to be allocated");
+
+  b.merge(a);
+  CHECK(b.size() == 125);
+  CHECK(a.size() == 26);
+  CHECK(a.at_left(0) == "0 is long enough to be allocated");
+  for (auto it = a.begin_left(); it != a.end_left(); ++it) {
+    CHECK((*it == 0 || (*it >= 50 && *it % 2 == 0)));
+  }
+  for (int i = 1; i < 100; i++) {
+    CHECK(b.at_left(i) == std::to_string(i) + " is long enough to be allocated");
+  }
+  CHECK(std::is_sorted(b.begin_right(), b.end_right()));
+
+  b.merge(b);
+  CHECK(b.size() == 125);
+
+  b.merge(std::move(a));
+  CHECK(b.size() == 125);
+  CHECK(a.size() == 26);
+}
+
+TEST_CASE("Merge relinks nodes") {
+  using allocator = counting_allocator<std::pair<int, std::string>>;
+  using bimap_t = bimap<int, std::string, std::less<int>, std::less<std::string>, allocator>;
+
+  allocation_stats stats;
+  allocation_stats other_stats;
+  {
+    bimap_t b({}, {}, allocator(&stats));
+    b.insert(-2, "-2 is long enough to be allocated");
+    {
+      bimap_t a({}, {}, allocator(&stats));
+      for (int i = 0; i < 100; i++) {
+        a.insert(i, std::to_string(i) + " is long enough to be allocated");
+      }
+      const std::string* address = &*a.find_left(42).flip();
+
+      std::size_t allocations = stats.allocations;
+      b.merge(a);
+      CHECK(a.empty());
+      CHECK(b.size() == 101);
+      CHECK(&*b.find_left(42).flip() == address);
+      // Only the list of shared slabs is allocated, not the nodes.
+      CHECK(stats.allocations - allocations <= 2);
+    }
+    // The slabs of `a` live on with the nodes in `b`.
+    CHECK(b.at_left(42) == "42 is long enough to be allocated");
+    b.erase_left(42);
+    b.insert(-1, "-1 is long enough to be allocated");
+
+    SECTION("Unequal allocators") {
+      bimap_t c({}, {}, allocator(&other_stats));
+      c.insert(1000, "1000 is long enough to be allocated");
+      const std::string* address = &*c.find_left(1000).flip();
+      b.merge(c);
+      CHECK(c.empty());
+      CHECK(b.at_left(1000) == "1000 is long enough to be allocated");
+      CHECK(&*b.find_left(1000).flip() != address);
+    }
+  }
+  CHECK(stats.allocations == stats.deallocations);
+  CHECK(stats.allocated_bytes == 0);
+  CHECK(other_stats.allocations == other_stats.deallocations);
+}
+
 TEST_CASE("Lower bound") {
   std::vector<std::pair<int, int>> data = {{1, 2}, {2, 3}, {3, 4}, {8, 16}, {32, 66}};
 
@@ -772,6 +1132,31 @@ TEST_CASE("Swap") {
   CHECK(*b.find_right(3) == 3);
 }
 
+TEST_CASE("Swap with empty") {
+  bimap<int, int> b, empty;
+  for (int i = 0; i < 10; i++) {
+    b.insert(i, -i);
+  }
+
+  using std::swap;
+  swap(b, empty);
+  CHECK(b.begin_left() == b.end_left());
+  CHECK(b.begin_right() == b.end_right());
+  CHECK(std::distance(empty.begin_left(), empty.end_left()) == 10);
+  CHECK(*std::prev(empty.end_left()) == 9);
+  CHECK(*std::prev(empty.end_right()) == 0);
+  CHECK(*empty.begin_right() == -9);
+
+  b.insert(1, 1);
+  CHECK(*b.begin_left() == 1);
+  CHECK(std::next(b.begin_left()) == b.end_left());
+  CHECK(std::prev(b.end_right()) == b.begin_right());
+
+  bimap<int, int> moved = std::move(empty);
+  CHECK(std::distance(moved.begin_right(), moved.end_right()) == 10);
+  CHECK(*std::prev(moved.end_left()) == 9);
+}
+
 TEST_CASE("Swap with tracking comparator") {
   using bimap = bimap<int, int, tracking_comparator, tracking_comparator>;
 
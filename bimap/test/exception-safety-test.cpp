@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <random>
+#include <utility>
+#include <vector>
 
 namespace {
 
@@ -128,6 +130,21 @@ TEST_CASE("Copy constructor is exception-safe") {
   });
 }
 
+TEST_CASE("Range constructor is exception-safe") {
+  std::vector<std::pair<int, int>> sorted = {{1, 2}, {3, 4}, {5, 6}, {7, 8}, {9, 10}};
+  std::vector<std::pair<int, int>> duplicates = {{1, 2}, {3, 4}, {9, 10}, {7, 8}, {7, 11}, {5, 4}};
+  faulty_run([&sorted] {
+    bimap<element, element> a(sorted.begin(), sorted.end());
+    fault_injection_disable dg;
+    CHECK(a.size() == 5);
+  });
+  faulty_run([&duplicates] {
+    bimap<element, element> a(duplicates.begin(), duplicates.end());
+    fault_injection_disable dg;
+    CHECK(a.size() == 4);
+  });
+}
+
 TEST_CASE("Copy assignment to empty is exception-safe") {
   faulty_run([] {
     bimap<element, element> a;
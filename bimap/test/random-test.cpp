@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <map>
 #include <random>
+#include <thread>
+#include <vector>
 
 namespace {
 
@@ -150,3 +152,31 @@ TEST_CASE("[Randomized] - Compare to 2 maps") {
   INFO("Comparing to maps stat:");
   INFO("Performed " << ins << " insertions and " << total - ins - skip << " erasures. " << skip << " skipped.");
 }
+
+TEST_CASE("[Randomized] - Bimaps on different threads") {
+  static constexpr int threads_count = 4;
+  static constexpr int N = 20'000;
+
+  std::vector<bimap<int, int>> bimaps(threads_count);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threads_count; t++) {
+    threads.emplace_back([&b = bimaps[t], t] {
+      std::mt19937 e(t);
+      for (int i = 0; i < N; i++) {
+        b.insert(static_cast<int>(e() % (N * 4)), i);
+      }
+      for (int i = 0; i < N / 2; i++) {
+        b.erase_right(i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& b : bimaps) {
+    CHECK(std::is_sorted(b.begin_left(), b.end_left()));
+    CHECK(std::is_sorted(b.begin_right(), b.end_right()));
+    CHECK(static_cast<std::size_t>(std::distance(b.begin_left(), b.end_left())) == b.size());
+  }
+}
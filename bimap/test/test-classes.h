@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <stdexcept>
 #include <unordered_set>
 #include <utility>
@@ -258,3 +260,41 @@ public:
 private:
   bool* called;
 };
+
+struct allocation_stats {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t allocated_bytes = 0;
+};
+
+template <typename T>
+class counting_allocator {
+public:
+  using value_type = T;
+
+  explicit counting_allocator(allocation_stats* stats)
+      : stats(stats) {}
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U>& other) noexcept
+      : stats(other.stats) {}
+
+  T* allocate(std::size_t n) {
+    stats->allocations++;
+    stats->allocated_bytes += n * sizeof(T);
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* ptr, std::size_t n) noexcept {
+    stats->deallocations++;
+    stats->allocated_bytes -= n * sizeof(T);
+    std::allocator<T>().deallocate(ptr, n);
+  }
+
+  template <typename U>
+  friend bool operator==(const counting_allocator& lhs, const counting_allocator<U>& rhs) noexcept {
+    return lhs.stats == rhs.stats;
+  }
+
+  allocation_stats* stats;
+};
@@ -0,0 +1,232 @@
+#include "test-classes.h"
+#include "unordered_bimap.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+template class unordered_bimap<int, std::string>;
+template class unordered_bimap<std::string, int>;
+
+namespace {
+
+struct string_hash {
+  using is_transparent = void;
+
+  std::size_t operator()(std::string_view value) const noexcept {
+    return std::hash<std::string_view>()(value);
+  }
+};
+
+template <typename Bimap, typename Left, typename Right>
+void check_contents(
+    const Bimap& b,
+    const std::unordered_map<Left, Right>& left,
+    const std::unordered_map<Right, Left>& right
+) {
+  REQUIRE(b.size() == left.size());
+  std::size_t count = 0;
+  for (auto it = b.begin_left(); it != b.end_left(); ++it, ++count) {
+    REQUIRE(left.at(*it) == *it.flip());
+    REQUIRE(it.flip().flip() == it);
+  }
+  REQUIRE(count == left.size());
+  for (const auto& [key, value] : right) {
+    REQUIRE(b.at_right(key) == value);
+  }
+}
+
+} // namespace
+
+TEST_CASE("Unordered: simple") {
+  unordered_bimap<int, int> b;
+  b.insert(4, 4);
+  CHECK(b.at_left(4) == 4);
+  CHECK(b.at_right(4) == 4);
+  CHECK_THROWS_AS(b.at_left(1), std::out_of_range);
+  CHECK_THROWS_AS(b.at_right(300), std::out_of_range);
+}
+
+TEST_CASE("Unordered: insert existing") {
+  unordered_bimap<int, int> b;
+  b.insert(1, 2);
+  b.insert(2, 3);
+  b.insert(3, 4);
+
+  CHECK(b.insert(2, -1) == b.end_left());
+  CHECK(b.insert(-1, 2) == b.end_left());
+  CHECK(b.size() == 3);
+  CHECK(b.at_left(2) == 3);
+  CHECK(b.at_right(2) == 1);
+}
+
+TEST_CASE("Unordered: flip") {
+  unordered_bimap<int, std::string> b;
+  auto it = b.insert(1, "one");
+  b.insert(2, "two");
+  CHECK(*it.flip() == "one");
+  CHECK(b.find_right("two").flip() == b.find_left(2));
+  CHECK(b.end_left().flip() == b.end_right());
+  CHECK(b.end_right().flip() == b.end_left());
+}
+
+TEST_CASE("Unordered: move-only keys") {
+  struct object_hash {
+    std::size_t operator()(const test_object& object) const noexcept {
+      return std::hash<int>()(object.a);
+    }
+  };
+
+  unordered_bimap<test_object, test_object, object_hash, object_hash> b;
+  for (int i = 0; i < 1000; i++) {
+    test_object left(i), right(-i);
+    b.insert(std::move(left), std::move(right));
+    CHECK(left.a == 0);
+  }
+  CHECK(b.size() == 1000);
+  CHECK(b.find_left(test_object(500)).flip()->a == -500);
+  CHECK(b.erase_right(test_object(-10)));
+  CHECK(b.find_left(test_object(10)) == b.end_left());
+  CHECK(b.size() == 999);
+}
+
+TEST_CASE("Unordered: erase") {
+  unordered_bimap<int, int> b;
+  for (int i = 0; i < 100; i++) {
+    b.insert(i, -i);
+  }
+
+  auto it = b.erase_left(b.find_left(10));
+  CHECK(it != b.end_left());
+  CHECK(b.at_left(*it) == *it.flip());
+  CHECK(b.find_left(10) == b.end_left());
+  CHECK(b.find_right(-10) == b.end_right());
+
+  for (auto rit = b.begin_right(); rit != b.end_right();) {
+    rit = *rit % 2 == 0 ? b.erase_right(rit) : std::next(rit);
+  }
+  CHECK(b.size() == 50);
+  CHECK_FALSE(b.erase_left(20));
+  CHECK(b.erase_left(21));
+  CHECK(b.size() == 49);
+}
+
+TEST_CASE("Unordered: at-or-default") {
+  unordered_bimap<int, int> b;
+  b.insert(4, 2);
+
+  CHECK(b.at_left_or_default(4) == 2);
+  CHECK(b.at_right_or_default(2) == 4);
+
+  CHECK(b.at_left_or_default(5) == 0);
+  CHECK(b.at_right(0) == 5);
+
+  CHECK(b.at_right_or_default(1) == 0);
+  CHECK(b.at_left(0) == 1);
+
+  CHECK(b.at_left_or_default(42) == 0); // (5, 0) is replaced with (42, 0)
+  CHECK(b.at_right(0) == 42);
+  CHECK(b.at_left(42) == 0);
+  CHECK(b.find_left(5) == b.end_left());
+
+  CHECK(b.at_right_or_default(1000) == 0); // (0, 1) is replaced with (0, 1000)
+  CHECK(b.at_left(0) == 1000);
+  CHECK(b.at_right(1000) == 0);
+  CHECK(b.find_right(1) == b.end_right());
+  CHECK(b.size() == 3);
+}
+
+TEST_CASE("Unordered: transparent lookup") {
+  unordered_bimap<std::string, std::string, string_hash, string_hash, std::equal_to<>, std::equal_to<>> b;
+  b.insert("id", "name");
+  b.insert("key", "value");
+
+  std::string_view id = "id";
+  CHECK(*b.find_left(id).flip() == "name");
+  CHECK(b.at_right(std::string_view("value")) == "key");
+  CHECK(b.find_right(std::string_view("missing")) == b.end_right());
+  CHECK(b.erase_left(id));
+  CHECK(b.size() == 1);
+}
+
+TEST_CASE("Unordered: copy, move and swap") {
+  unordered_bimap<int, int> b;
+  for (int i = 0; i < 1000; i++) {
+    b.insert(i, i * 3 % 1000);
+  }
+
+  unordered_bimap<int, int> copy = b;
+  CHECK(copy == b);
+
+  copy.erase_left(7);
+  CHECK(copy != b);
+
+  unordered_bimap<int, int> moved = std::move(b);
+  CHECK(moved.size() == 1000);
+  CHECK(moved.at_right(21) == 7);
+
+  using std::swap;
+  swap(moved, copy);
+  CHECK(moved.size() == 999);
+  CHECK(copy.size() == 1000);
+
+  copy = moved;
+  CHECK(copy == moved);
+}
+
+TEST_CASE("Unordered: reserve") {
+  unordered_bimap<int, int> b;
+  b.reserve(1000);
+  for (int i = 0; i < 1000; i++) {
+    b.insert(i, -i);
+  }
+  CHECK(b.size() == 1000);
+  CHECK(b.at_right(-999) == 999);
+}
+
+TEST_CASE("[Randomized] - Unordered against std::unordered_map") {
+  unordered_bimap<int, int> b;
+  std::unordered_map<int, int> left;
+  std::unordered_map<int, int> right;
+
+  std::mt19937 e(1488228);
+  for (int i = 0; i < 200'000; i++) {
+    auto op = e() % 10;
+    int l = static_cast<int>(e() % 5000);
+    int r = static_cast<int>(e() % 5000);
+    if (op < 6) {
+      bool inserted = !left.contains(l) && !right.contains(r);
+      auto it = b.insert(l, r);
+      REQUIRE((it != b.end_left()) == inserted);
+      if (inserted) {
+        REQUIRE(*it.flip() == r);
+        left.emplace(l, r);
+        right.emplace(r, l);
+      }
+    } else if (op < 8) {
+      bool erased = left.contains(l);
+      REQUIRE(b.erase_left(l) == erased);
+      if (erased) {
+        right.erase(left.at(l));
+        left.erase(l);
+      }
+    } else {
+      auto it = b.find_right(r);
+      REQUIRE((it != b.end_right()) == right.contains(r));
+      if (it != b.end_right()) {
+        REQUIRE(*it.flip() == right.at(r));
+        b.erase_right(it);
+        left.erase(right.at(r));
+        right.erase(r);
+      }
+    }
+    if (i % 1000 == 0) {
+      check_contents(b, left, right);
+    }
+  }
+  check_contents(b, left, right);
+}
@@ -0,0 +1,252 @@
+#include "bitset-parallel.h"
+#include "bitset.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace {
+constexpr std::int64_t min_size = 64;
+constexpr std::int64_t max_size = std::int64_t(1) << 30;
+// Per-bit loops and text conversions take too long or too much memory at the largest sizes.
+constexpr std::int64_t max_slow_size = std::int64_t(1) << 26;
+
+bitset random_bitset(std::size_t size, unsigned seed) {
+  std::mt19937_64 rng(seed);
+  bitset bs(size, false);
+  std::size_t words = (size + constants::word_size_bits - 1) / constants::word_size_bits;
+  for (std::size_t ind = 0; ind < words; ++ind) {
+    bs.data()[ind] = rng();
+  }
+  if (size % constants::word_size_bits != 0) {
+    bs.data()[words - 1] &= constants::max >> (constants::word_size_bits - size % constants::word_size_bits);
+  }
+  return bs;
+}
+
+std::string random_string(std::size_t size) {
+  std::mt19937_64 rng(size);
+  std::string str(size, '0');
+  for (auto& c : str) {
+    c = (rng() % 2 == 0) ? '0' : '1';
+  }
+  return str;
+}
+
+void set_bytes(benchmark::State& state, std::size_t bytes) {
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(bytes));
+}
+
+std::size_t bench_size(const benchmark::State& state) {
+  return static_cast<std::size_t>(state.range(0));
+}
+
+void construct_filled(benchmark::State& state) {
+  for (auto _ : state) {
+    bitset bs(bench_size(state), true);
+    benchmark::DoNotOptimize(bs.data());
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+void construct_copy(benchmark::State& state) {
+  const bitset source = random_bitset(bench_size(state), 1);
+  for (auto _ : state) {
+    bitset bs(source);
+    benchmark::DoNotOptimize(bs.data());
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+void construct_unaligned_view(benchmark::State& state) {
+  const bitset source = random_bitset(bench_size(state) + 3, 1);
+  for (auto _ : state) {
+    bitset bs(source.subview(3));
+    benchmark::DoNotOptimize(bs.data());
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+void parse_string(benchmark::State& state) {
+  const std::string str = random_string(bench_size(state));
+  for (auto _ : state) {
+    bitset bs(str);
+    benchmark::DoNotOptimize(bs.data());
+  }
+  set_bytes(state, str.size());
+}
+
+void format_string(benchmark::State& state) {
+  const bitset bs = random_bitset(bench_size(state), 1);
+  for (auto _ : state) {
+    std::string str = to_string(bs);
+    benchmark::DoNotOptimize(str.data());
+  }
+  set_bytes(state, bs.size());
+}
+
+template <typename Operation>
+void binary_aligned(benchmark::State& state) {
+  bitset lhs = random_bitset(bench_size(state), 1);
+  const bitset rhs = random_bitset(bench_size(state), 2);
+  for (auto _ : state) {
+    Operation()(lhs.subview(), rhs.subview());
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+template <typename Operation>
+void binary_unaligned(benchmark::State& state) {
+  bitset lhs = random_bitset(bench_size(state) + 1, 1);
+  const bitset rhs = random_bitset(bench_size(state) + 3, 2);
+  for (auto _ : state) {
+    Operation()(lhs.subview(1), rhs.subview(3));
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+struct and_assign {
+  void operator()(const bitset::view& lhs, const bitset::const_view& rhs) const {
+    lhs &= rhs;
+  }
+};
+
+struct or_assign {
+  void operator()(const bitset::view& lhs, const bitset::const_view& rhs) const {
+    lhs |= rhs;
+  }
+};
+
+struct xor_assign {
+  void operator()(const bitset::view& lhs, const bitset::const_view& rhs) const {
+    lhs ^= rhs;
+  }
+};
+
+// Evaluating a single operation should cost what copying and assigning in place does.
+void expression_binary(benchmark::State& state) {
+  const bitset a = random_bitset(bench_size(state), 1);
+  const bitset b = random_bitset(bench_size(state), 2);
+  for (auto _ : state) {
+    bitset bs = a & b;
+    benchmark::DoNotOptimize(bs.data());
+  }
+  set_bytes(state, 2 * bench_size(state) / 8);
+}
+
+void copy_and_assign(benchmark::State& state) {
+  const bitset a = random_bitset(bench_size(state), 1);
+  const bitset b = random_bitset(bench_size(state), 2);
+  for (auto _ : state) {
+    bitset bs = a;
+    bs &= b;
+    benchmark::DoNotOptimize(bs.data());
+  }
+  set_bytes(state, 2 * bench_size(state) / 8);
+}
+
+void expression_chain(benchmark::State& state) {
+  const bitset a = random_bitset(bench_size(state), 1);
+  const bitset b = random_bitset(bench_size(state), 2);
+  const bitset c = random_bitset(bench_size(state), 3);
+  for (auto _ : state) {
+    bitset bs = (a & b) | ~c;
+    benchmark::DoNotOptimize(bs.data());
+  }
+  set_bytes(state, 3 * bench_size(state) / 8);
+}
+
+void shift_copy(benchmark::State& state) {
+  const bitset bs = random_bitset(bench_size(state), 1);
+  for (auto _ : state) {
+    bitset shifted = bs << 13;
+    benchmark::DoNotOptimize(shifted.data());
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+void shift_view(benchmark::State& state) {
+  bitset bs = random_bitset(bench_size(state), 1);
+  for (auto _ : state) {
+    bs.subview() <<= 13;
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+void count_aligned(benchmark::State& state) {
+  const bitset bs = random_bitset(bench_size(state), 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bs.count());
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+void count_unaligned(benchmark::State& state) {
+  const bitset bs = random_bitset(bench_size(state) + 5, 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bs.subview(5).count());
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+void count_parallel(benchmark::State& state) {
+  const bitset bs = random_bitset(bench_size(state), 1);
+  const bitset_parallel executor;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(executor.count(bs));
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+void iterate_bits(benchmark::State& state) {
+  const bitset bs = random_bitset(bench_size(state), 1);
+  for (auto _ : state) {
+    std::size_t ones = 0;
+    for (bool bit : bs) {
+      ones += bit;
+    }
+    benchmark::DoNotOptimize(ones);
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+
+void iterate_set_bits(benchmark::State& state) {
+  const bitset bs = random_bitset(bench_size(state), 1);
+  for (auto _ : state) {
+    std::size_t sum = 0;
+    for (std::size_t pos : bs.set_bits()) {
+      sum += pos;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  set_bytes(state, bench_size(state) / 8);
+}
+} // namespace
+
+BENCHMARK(construct_filled)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(construct_copy)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(construct_unaligned_view)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(parse_string)->RangeMultiplier(64)->Range(min_size, max_slow_size);
+BENCHMARK(format_string)->RangeMultiplier(64)->Range(min_size, max_slow_size);
+BENCHMARK(binary_aligned<and_assign>)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(binary_aligned<or_assign>)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(binary_aligned<xor_assign>)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(binary_unaligned<and_assign>)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(binary_unaligned<or_assign>)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(binary_unaligned<xor_assign>)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(expression_binary)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(copy_and_assign)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(expression_chain)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(shift_copy)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(shift_view)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(count_aligned)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(count_unaligned)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(count_parallel)->RangeMultiplier(64)->Range(min_size, max_size);
+BENCHMARK(iterate_bits)->RangeMultiplier(64)->Range(min_size, max_slow_size);
+BENCHMARK(iterate_set_bits)->RangeMultiplier(64)->Range(min_size, max_size);
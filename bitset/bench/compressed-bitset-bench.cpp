@@ -0,0 +1,88 @@
+#include "bitset.h"
+#include "compressed-bitset.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+namespace {
+constexpr std::size_t bench_size = 1 << 24;
+
+enum class pattern {
+  sparse,
+  dense,
+  clustered,
+};
+
+bitset make_bitset(pattern kind, unsigned seed) {
+  std::mt19937_64 rng(seed);
+  bitset bs(bench_size, kind == pattern::dense);
+  if (kind == pattern::clustered) {
+    for (std::size_t pos = rng() % 100000; pos < bench_size; pos += 100000 + rng() % 100000) {
+      bs.subview(pos, 20000 + rng() % 20000).set();
+    }
+  } else {
+    for (std::size_t i = 0; i < bench_size / 1000; ++i) {
+      bs[rng() % bench_size].flip();
+    }
+  }
+  return bs;
+}
+
+template <pattern kind>
+void and_dense(benchmark::State& state) {
+  bitset lhs = make_bitset(kind, 1);
+  const bitset rhs = make_bitset(kind, 2);
+  for (auto _ : state) {
+    lhs &= rhs;
+    benchmark::DoNotOptimize(lhs.count());
+  }
+  state.counters["bytes"] = static_cast<double>(bench_size / 8);
+}
+
+template <pattern kind>
+void and_compressed(benchmark::State& state) {
+  compressed_bitset lhs(make_bitset(kind, 1));
+  const compressed_bitset rhs(make_bitset(kind, 2));
+  for (auto _ : state) {
+    lhs &= rhs;
+    benchmark::DoNotOptimize(lhs.count());
+  }
+  state.counters["bytes"] = static_cast<double>(lhs.memory_usage());
+}
+
+template <pattern kind>
+void and_compressed_dense(benchmark::State& state) {
+  compressed_bitset lhs(make_bitset(kind, 1));
+  const bitset rhs = make_bitset(kind, 2);
+  for (auto _ : state) {
+    lhs &= rhs;
+    benchmark::DoNotOptimize(lhs.count());
+  }
+}
+
+template <pattern kind>
+void compress(benchmark::State& state) {
+  const bitset bs = make_bitset(kind, 1);
+  for (auto _ : state) {
+    compressed_bitset compressed(bs);
+    benchmark::DoNotOptimize(compressed.count());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bench_size / 8));
+}
+} // namespace
+
+BENCHMARK(and_dense<pattern::sparse>);
+BENCHMARK(and_dense<pattern::dense>);
+BENCHMARK(and_dense<pattern::clustered>);
+BENCHMARK(and_compressed<pattern::sparse>);
+BENCHMARK(and_compressed<pattern::dense>);
+BENCHMARK(and_compressed<pattern::clustered>);
+BENCHMARK(and_compressed_dense<pattern::sparse>);
+BENCHMARK(and_compressed_dense<pattern::dense>);
+BENCHMARK(and_compressed_dense<pattern::clustered>);
+BENCHMARK(compress<pattern::sparse>);
+BENCHMARK(compress<pattern::dense>);
+BENCHMARK(compress<pattern::clustered>);
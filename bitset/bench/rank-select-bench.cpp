@@ -0,0 +1,86 @@
+#include "bitset-rank-select.h"
+#include "bitset.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace {
+bitset random_bitset(std::size_t size) {
+  std::mt19937_64 rng(size);
+  bitset bs(size, false);
+  for (std::size_t i = 0; i < size; ++i) {
+    bs[i] = (rng() % 4 == 0);
+  }
+  return bs;
+}
+
+std::vector<std::size_t> random_queries(std::size_t bound) {
+  std::mt19937_64 rng(bound);
+  std::vector<std::size_t> queries(1024);
+  for (auto& query : queries) {
+    query = static_cast<std::size_t>(rng() % bound);
+  }
+  return queries;
+}
+
+void rank_naive(benchmark::State& state) {
+  const bitset bs = random_bitset(static_cast<std::size_t>(state.range(0)));
+  auto queries = random_queries(bs.size());
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bs.subview(0, queries[i++ % queries.size()]).count());
+  }
+}
+
+void rank_index(benchmark::State& state) {
+  const bitset bs = random_bitset(static_cast<std::size_t>(state.range(0)));
+  bitset_rank_select index(bs);
+  auto queries = random_queries(bs.size());
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.rank1(queries[i++ % queries.size()]));
+  }
+}
+
+void select_naive(benchmark::State& state) {
+  const bitset bs = random_bitset(static_cast<std::size_t>(state.range(0)));
+  auto queries = random_queries(bs.count());
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t rank = queries[i++ % queries.size()];
+    std::size_t pos = bs.find_first();
+    for (std::size_t k = 0; k < rank; ++k) {
+      pos = bs.find_next(pos);
+    }
+    benchmark::DoNotOptimize(pos);
+  }
+}
+
+void select_index(benchmark::State& state) {
+  const bitset bs = random_bitset(static_cast<std::size_t>(state.range(0)));
+  bitset_rank_select index(bs);
+  auto queries = random_queries(bs.count());
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.select1(queries[i++ % queries.size()]));
+  }
+}
+
+void build_index(benchmark::State& state) {
+  const bitset bs = random_bitset(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    bitset_rank_select index(bs);
+    benchmark::DoNotOptimize(index.rank1(0));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0) / 8);
+}
+} // namespace
+
+BENCHMARK(rank_naive)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(rank_index)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(select_naive)->RangeMultiplier(16)->Range(1 << 12, 1 << 16);
+BENCHMARK(select_index)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(build_index)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
@@ -0,0 +1,178 @@
+#include "atomic-bitset.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace {
+// Number of words read from a view at once by the bulk operations.
+constexpr std::size_t chunk_words = 512;
+
+constants::word_type bit_mask(std::size_t index) {
+  return constants::one << (index % constants::word_size_bits);
+}
+} // namespace
+
+atomic_bitset::atomic_bitset(std::size_t size, bool value)
+    : data_(new std::atomic<word_type>[(size + constants::word_size_bits - 1) / constants::word_size_bits]())
+    , size_(size) {
+  if (value) {
+    set();
+  }
+}
+
+atomic_bitset::atomic_bitset(const const_view& vw)
+    : atomic_bitset(vw.size(), false) {
+  *this |= vw;
+}
+
+bitset atomic_bitset::to_bitset() const {
+  bitset ans(size_, false);
+  for (std::size_t ind = 0; ind < words(); ++ind) {
+    ans.data()[ind] = data_[ind].load(std::memory_order_relaxed);
+  }
+  return ans;
+}
+
+std::size_t atomic_bitset::size() const {
+  return size_;
+}
+
+bool atomic_bitset::empty() const {
+  return size_ == 0;
+}
+
+atomic_bitset::reference atomic_bitset::operator[](std::size_t index) {
+  return {data_[index / constants::word_size_bits], bit_mask(index)};
+}
+
+bool atomic_bitset::operator[](std::size_t index) const {
+  return test(index);
+}
+
+bool atomic_bitset::test(std::size_t index, std::memory_order order) const {
+  return (data_[index / constants::word_size_bits].load(order) & bit_mask(index)) != 0;
+}
+
+void atomic_bitset::set(std::size_t index, std::memory_order order) {
+  data_[index / constants::word_size_bits].fetch_or(bit_mask(index), order);
+}
+
+void atomic_bitset::reset(std::size_t index, std::memory_order order) {
+  data_[index / constants::word_size_bits].fetch_and(~bit_mask(index), order);
+}
+
+void atomic_bitset::flip(std::size_t index, std::memory_order order) {
+  data_[index / constants::word_size_bits].fetch_xor(bit_mask(index), order);
+}
+
+bool atomic_bitset::test_and_set(std::size_t index, std::memory_order order) {
+  return (data_[index / constants::word_size_bits].fetch_or(bit_mask(index), order) & bit_mask(index)) != 0;
+}
+
+bool atomic_bitset::test_and_reset(std::size_t index, std::memory_order order) {
+  return (data_[index / constants::word_size_bits].fetch_and(~bit_mask(index), order) & bit_mask(index)) != 0;
+}
+
+atomic_bitset& atomic_bitset::operator&=(const const_view& other) {
+  for_each_word(other, [](std::atomic<word_type>& word, word_type value) {
+    word.fetch_and(value, std::memory_order_relaxed);
+  });
+  return *this;
+}
+
+atomic_bitset& atomic_bitset::operator|=(const const_view& other) {
+  for_each_word(other, [](std::atomic<word_type>& word, word_type value) {
+    word.fetch_or(value, std::memory_order_relaxed);
+  });
+  return *this;
+}
+
+atomic_bitset& atomic_bitset::operator^=(const const_view& other) {
+  for_each_word(other, [](std::atomic<word_type>& word, word_type value) {
+    word.fetch_xor(value, std::memory_order_relaxed);
+  });
+  return *this;
+}
+
+atomic_bitset& atomic_bitset::flip() {
+  for (std::size_t ind = 0; ind < words(); ++ind) {
+    data_[ind].fetch_xor(ind + 1 == words() ? tail_mask() : constants::max, std::memory_order_relaxed);
+  }
+  return *this;
+}
+
+atomic_bitset& atomic_bitset::set() {
+  for (std::size_t ind = 0; ind < words(); ++ind) {
+    data_[ind].store(ind + 1 == words() ? tail_mask() : constants::max, std::memory_order_relaxed);
+  }
+  return *this;
+}
+
+atomic_bitset& atomic_bitset::reset() {
+  for (std::size_t ind = 0; ind < words(); ++ind) {
+    data_[ind].store(0, std::memory_order_relaxed);
+  }
+  return *this;
+}
+
+bool atomic_bitset::all() const {
+  for (std::size_t ind = 0; ind < words(); ++ind) {
+    if (data_[ind].load(std::memory_order_relaxed) != (ind + 1 == words() ? tail_mask() : constants::max)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool atomic_bitset::any() const {
+  for (std::size_t ind = 0; ind < words(); ++ind) {
+    if (data_[ind].load(std::memory_order_relaxed) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::size_t atomic_bitset::count() const {
+  std::size_t ans = 0;
+  for (std::size_t ind = 0; ind < words(); ++ind) {
+    ans += static_cast<std::size_t>(std::popcount(data_[ind].load(std::memory_order_relaxed)));
+  }
+  return ans;
+}
+
+void atomic_bitset::swap(atomic_bitset& other) {
+  std::swap(data_, other.data_);
+  std::swap(size_, other.size_);
+}
+
+std::size_t atomic_bitset::words() const {
+  return (size_ + constants::word_size_bits - 1) / constants::word_size_bits;
+}
+
+atomic_bitset::word_type atomic_bitset::tail_mask() const {
+  std::size_t bits = size_ % constants::word_size_bits;
+  return bits == 0 ? constants::max : constants::max >> (constants::word_size_bits - bits);
+}
+
+// Calls func(word, value) for every word of this bitset and the corresponding word of the view.
+template <typename Func>
+void atomic_bitset::for_each_word(const const_view& other, Func func) {
+  std::array<word_type, chunk_words> buffer{};
+  for (std::size_t pos = 0; pos < size_; pos += chunk_words * constants::word_size_bits) {
+    std::size_t count = std::min(chunk_words * constants::word_size_bits, size_ - pos);
+    count = other.copy_words(buffer.data(), pos, count);
+    std::size_t first = pos / constants::word_size_bits;
+    for (std::size_t ind = 0; ind < (count + constants::word_size_bits - 1) / constants::word_size_bits; ++ind) {
+      func(data_[first + ind], buffer[ind]);
+    }
+  }
+}
+
+void swap(atomic_bitset& lhs, atomic_bitset& rhs) {
+  lhs.swap(rhs);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Fixed-size bitset whose bits can be changed by several threads without locks.
+// Operations on single bits are atomic read-modify-writes of the containing word.
+// Bulk operations are atomic for every word with relaxed ordering, but not as a whole.
+class atomic_bitset {
+public:
+  using word_type = constants::word_type;
+  using const_view = bitset::const_view;
+
+  class reference {
+  public:
+    reference(const reference& other) = default;
+
+    operator bool() const {
+      return (word_->load() & mask_) != 0;
+    }
+
+    reference& operator=(bool value) {
+      if (value) {
+        word_->fetch_or(mask_);
+      } else {
+        word_->fetch_and(~mask_);
+      }
+      return *this;
+    }
+
+    reference& operator=(const reference& other) {
+      return *this = static_cast<bool>(other);
+    }
+
+    reference& flip() {
+      word_->fetch_xor(mask_);
+      return *this;
+    }
+
+  private:
+    reference(std::atomic<word_type>& word, word_type mask)
+        : word_(&word)
+        , mask_(mask) {}
+
+    friend class atomic_bitset;
+
+    std::atomic<word_type>* word_;
+    word_type mask_;
+  };
+
+  atomic_bitset() = default;
+  atomic_bitset(std::size_t size, bool value);
+  explicit atomic_bitset(const const_view& vw);
+
+  atomic_bitset(const atomic_bitset& other) = delete;
+  atomic_bitset(atomic_bitset&& other) noexcept = default;
+  atomic_bitset& operator=(const atomic_bitset& other) = delete;
+  atomic_bitset& operator=(atomic_bitset&& other) noexcept = default;
+
+  // Word by word snapshot, consistent only if there are no concurrent writes.
+  bitset to_bitset() const;
+
+  std::size_t size() const;
+  bool empty() const;
+
+  reference operator[](std::size_t index);
+  bool operator[](std::size_t index) const;
+
+  bool test(std::size_t index, std::memory_order order = std::memory_order_seq_cst) const;
+  void set(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+  void reset(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+  void flip(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+
+  // Return the previous value of the bit.
+  bool test_and_set(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+  bool test_and_reset(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+
+  // The view must have the same size.
+  atomic_bitset& operator&=(const const_view& other);
+  atomic_bitset& operator|=(const const_view& other);
+  atomic_bitset& operator^=(const const_view& other);
+  atomic_bitset& flip();
+  atomic_bitset& set();
+  atomic_bitset& reset();
+
+  bool all() const;
+  bool any() const;
+  std::size_t count() const;
+
+  void swap(atomic_bitset& other);
+
+private:
+  std::size_t words() const;
+  word_type tail_mask() const;
+
+  template <typename Func>
+  void for_each_word(const const_view& other, Func func);
+
+  std::unique_ptr<std::atomic<word_type>[]> data_;
+  std::size_t size_ = 0;
+};
+
+void swap(atomic_bitset& lhs, atomic_bitset& rhs);
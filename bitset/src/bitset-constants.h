@@ -9,4 +9,6 @@ static constexpr std::size_t word_size_bits = std::numeric_limits<word_type>::di
 static constexpr word_type max = -1;
 static constexpr word_type one = 1;
 static constexpr std::size_t npos = -1;
+// Number of words stored inline in a bitset before it switches to the heap.
+static constexpr std::size_t small_words = 2;
 } // namespace constants
@@ -0,0 +1,418 @@
+#pragma once
+
+#include "bitset-constants.h"
+#include "bitset-iterator.h"
+#include "bitset-kernels.h"
+#include "bitset-view.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+class bitset;
+
+// Lazy result of the free bitwise operators. Nothing is computed until the expression is converted
+// to a bitset or reduced, then the whole chain is evaluated in chunks of words with the vector kernels.
+// Bitsets passed as lvalues are referenced, so an expression must not outlive them; temporary
+// bitsets are moved into the expression.
+// Every node provides size() and word(index), the latter with zero bits past size(). Nodes may
+// also provide evaluate_words() and words_at() for a faster evaluation of ranges of words.
+template <typename Derived>
+class bitset_expression {
+public:
+  using word_type = constants::word_type;
+
+  // Number of words evaluated at once into a buffer on the stack.
+  static constexpr std::size_t chunk_words = 256;
+
+  std::size_t words() const {
+    return (derived().size() + constants::word_size_bits - 1) / constants::word_size_bits;
+  }
+
+  bool empty() const {
+    return derived().size() == 0;
+  }
+
+  bool operator[](std::size_t pos) const {
+    return (derived().word(pos / constants::word_size_bits) >> (pos % constants::word_size_bits)) & 1;
+  }
+
+  bool all() const {
+    std::size_t full_words = derived().size() / constants::word_size_bits;
+    bool full = for_each_chunk(full_words, [](const word_type* src, std::size_t count) {
+      return !kernels::all(src, count);
+    });
+    return !full && (full_words == words() || derived().word(full_words) == tail_mask(derived().size()));
+  }
+
+  bool any() const {
+    return for_each_chunk(words(), [](const word_type* src, std::size_t count) { return kernels::any(src, count); });
+  }
+
+  std::size_t count() const {
+    std::size_t ans = 0;
+    for_each_chunk(words(), [&](const word_type* src, std::size_t count) {
+      ans += kernels::popcount(src, count);
+      return false;
+    });
+    return ans;
+  }
+
+  void evaluate(word_type* dst) const {
+    derived().evaluate_words(dst, 0, words());
+  }
+
+  // Writes the words [first, first + count) to `dst`.
+  void evaluate_words(word_type* dst, std::size_t first, std::size_t count) const {
+    for (std::size_t ind = 0; ind < count; ++ind) {
+      dst[ind] = derived().word(first + ind);
+    }
+  }
+
+  // Pointer to the words [first, first + count), either stored by a leaf or evaluated into `buffer`.
+  const word_type* words_at(std::size_t first, std::size_t count, word_type* buffer) const {
+    derived().evaluate_words(buffer, first, count);
+    return buffer;
+  }
+
+  // Combines the words [first, first + count) into `dst` with the kernel of `Operation`.
+  template <typename Operation>
+  void apply_words(word_type* dst, std::size_t first, std::size_t count) const {
+    std::array<word_type, chunk_words> buffer;
+    for (std::size_t pos = 0; pos < count; pos += chunk_words) {
+      std::size_t length = std::min(chunk_words, count - pos);
+      apply_kernel<Operation>(dst + pos, derived().words_at(first + pos, length, buffer.data()), length);
+    }
+  }
+
+  // The expression is evaluated into a bitset on the first call and kept, the views are valid while
+  // the expression lives. This lets expressions be passed where views are expected.
+  operator bitset_view<const word_type>() const;
+  bitset_view<const word_type> subview(std::size_t offset = 0, std::size_t count = constants::npos) const;
+  bitset_iterator<const word_type> begin() const;
+  bitset_iterator<const word_type> end() const;
+
+protected:
+  // Mask of the bits of the last word of a sequence of `size` bits.
+  static word_type tail_mask(std::size_t size) {
+    std::size_t bits = size % constants::word_size_bits;
+    return bits == 0 ? constants::max : constants::max >> (constants::word_size_bits - bits);
+  }
+
+  // Clears the bits past size() if the words [first, first + count) end with the last one.
+  void mask_tail(word_type* dst, std::size_t first, std::size_t count) const {
+    if (count != 0 && first + count == words()) {
+      dst[count - 1] &= tail_mask(derived().size());
+    }
+  }
+
+  template <typename Operation>
+  static void apply_kernel(word_type* dst, const word_type* src, std::size_t count) {
+    if constexpr (std::is_same_v<Operation, std::bit_and<>>) {
+      kernels::bit_and(dst, src, count);
+    } else if constexpr (std::is_same_v<Operation, std::bit_or<>>) {
+      kernels::bit_or(dst, src, count);
+    } else if constexpr (std::is_same_v<Operation, std::bit_xor<>>) {
+      kernels::bit_xor(dst, src, count);
+    } else {
+      std::transform(dst, dst + count, src, dst, Operation());
+    }
+  }
+
+private:
+  const Derived& derived() const {
+    return static_cast<const Derived&>(*this);
+  }
+
+  // Calls func(words, count) for consecutive chunks of the first `words` words until it returns true.
+  template <typename Func>
+  bool for_each_chunk(std::size_t words, Func func) const {
+    std::array<word_type, chunk_words> buffer;
+    for (std::size_t pos = 0; pos < words; pos += chunk_words) {
+      std::size_t length = std::min(chunk_words, words - pos);
+      if (func(derived().words_at(pos, length, buffer.data()), length)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  mutable std::shared_ptr<const bitset> materialized_;
+};
+
+// Leaf of an expression, reads words of a view of any alignment.
+class bitset_operand : public bitset_expression<bitset_operand> {
+public:
+  explicit bitset_operand(const bitset_view<const word_type>& vw)
+      : data_(vw.begin().word())
+      , offset_(vw.begin().offset())
+      , size_(vw.size()) {}
+
+  std::size_t size() const {
+    return size_;
+  }
+
+  word_type word(std::size_t index) const {
+    std::size_t count = std::min(constants::word_size_bits, size_ - index * constants::word_size_bits);
+    word_type ans = data_[index] >> offset_;
+    if (offset_ != 0 && offset_ + count > constants::word_size_bits) {
+      ans |= data_[index + 1] << (constants::word_size_bits - offset_);
+    }
+    return count == constants::word_size_bits ? ans : ans & tail_mask(count);
+  }
+
+  void evaluate_words(word_type* dst, std::size_t first, std::size_t count) const {
+    if (offset_ != 0) {
+      bitset_expression::evaluate_words(dst, first, count);
+      return;
+    }
+    std::copy_n(data_ + first, count, dst);
+    mask_tail(dst, first, count);
+  }
+
+  // Aligned words before the last one are read in place.
+  const word_type* words_at(std::size_t first, std::size_t count, word_type* buffer) const {
+    if (offset_ == 0 && (first + count) * constants::word_size_bits <= size_) {
+      return data_ + first;
+    }
+    evaluate_words(buffer, first, count);
+    return buffer;
+  }
+
+private:
+  const word_type* data_;
+  std::size_t offset_;
+  std::size_t size_;
+};
+
+// Leaf that owns a temporary bitset, the copies of the expression share it.
+template <typename Bitset>
+class bitset_owning_operand : public bitset_expression<bitset_owning_operand<Bitset>> {
+public:
+  using word_type = constants::word_type;
+
+  explicit bitset_owning_operand(Bitset bits)
+      : bits_(std::make_shared<const Bitset>(std::move(bits)))
+      , operand_(*bits_) {}
+
+  std::size_t size() const {
+    return operand_.size();
+  }
+
+  word_type word(std::size_t index) const {
+    return operand_.word(index);
+  }
+
+  void evaluate_words(word_type* dst, std::size_t first, std::size_t count) const {
+    operand_.evaluate_words(dst, first, count);
+  }
+
+  const word_type* words_at(std::size_t first, std::size_t count, word_type* buffer) const {
+    return operand_.words_at(first, count, buffer);
+  }
+
+private:
+  std::shared_ptr<const Bitset> bits_;
+  bitset_operand operand_;
+};
+
+template <typename Operation, typename Left, typename Right>
+class bitset_binary_expression : public bitset_expression<bitset_binary_expression<Operation, Left, Right>> {
+public:
+  using word_type = constants::word_type;
+
+  bitset_binary_expression(const Left& lhs, const Right& rhs)
+      : lhs_(lhs)
+      , rhs_(rhs) {}
+
+  std::size_t size() const {
+    return lhs_.size();
+  }
+
+  word_type word(std::size_t index) const {
+    return Operation()(lhs_.word(index), rhs_.word(index));
+  }
+
+  void evaluate_words(word_type* dst, std::size_t first, std::size_t count) const {
+    lhs_.evaluate_words(dst, first, count);
+    rhs_.template apply_words<Operation>(dst, first, count);
+  }
+
+private:
+  Left lhs_;
+  Right rhs_;
+};
+
+template <typename Expression>
+class bitset_not_expression : public bitset_expression<bitset_not_expression<Expression>> {
+public:
+  using word_type = constants::word_type;
+
+  explicit bitset_not_expression(const Expression& expr)
+      : expr_(expr) {}
+
+  std::size_t size() const {
+    return expr_.size();
+  }
+
+  word_type word(std::size_t index) const {
+    word_type ans = ~expr_.word(index);
+    return index + 1 == this->words() ? ans & this->tail_mask(size()) : ans;
+  }
+
+  void evaluate_words(word_type* dst, std::size_t first, std::size_t count) const {
+    expr_.evaluate_words(dst, first, count);
+    kernels::bit_not(dst, count);
+    this->mask_tail(dst, first, count);
+  }
+
+private:
+  Expression expr_;
+};
+
+// Prefix of an expression extended with zeros or truncated to `size` bits, the result of shifts.
+template <typename Expression>
+class bitset_resize_expression : public bitset_expression<bitset_resize_expression<Expression>> {
+public:
+  using word_type = constants::word_type;
+
+  bitset_resize_expression(const Expression& expr, std::size_t size)
+      : expr_(expr)
+      , size_(size) {}
+
+  std::size_t size() const {
+    return size_;
+  }
+
+  word_type word(std::size_t index) const {
+    if (index >= expr_.words()) {
+      return 0;
+    }
+    word_type ans = expr_.word(index);
+    return index + 1 == this->words() ? ans & this->tail_mask(size_) : ans;
+  }
+
+  void evaluate_words(word_type* dst, std::size_t first, std::size_t count) const {
+    std::size_t inner = first < expr_.words() ? std::min(count, expr_.words() - first) : 0;
+    expr_.evaluate_words(dst, first, inner);
+    std::fill(dst + inner, dst + count, word_type(0));
+    this->mask_tail(dst, first, count);
+  }
+
+private:
+  Expression expr_;
+  std::size_t size_;
+};
+
+// Operands are recognized by their exact types, so that the operators do not require
+// unrelated argument types, such as streams or range adaptors, to be complete.
+template <typename T>
+inline constexpr bool is_bitset_expression = false;
+
+template <>
+inline constexpr bool is_bitset_expression<bitset_operand> = true;
+
+template <typename Bitset>
+inline constexpr bool is_bitset_expression<bitset_owning_operand<Bitset>> = true;
+
+template <typename Operation, typename Left, typename Right>
+inline constexpr bool is_bitset_expression<bitset_binary_expression<Operation, Left, Right>> = true;
+
+template <typename Expression>
+inline constexpr bool is_bitset_expression<bitset_not_expression<Expression>> = true;
+
+template <typename Expression>
+inline constexpr bool is_bitset_expression<bitset_resize_expression<Expression>> = true;
+
+template <typename T>
+inline constexpr bool is_bitset_view = false;
+
+template <typename T>
+inline constexpr bool is_bitset_view<bitset_view<T>> = true;
+
+template <typename T>
+concept bitset_expression_type = is_bitset_expression<T>;
+
+template <typename T>
+concept bitset_operand_type = bitset_expression_type<T> || is_bitset_view<T> || std::same_as<T, bitset>;
+
+template <typename T>
+concept temporary_bitset = std::same_as<std::remove_cv_t<T>, bitset>;
+
+template <typename T>
+concept forwarded_operand = bitset_operand_type<std::remove_cvref_t<T>>;
+
+// Expressions are copied into their parents, temporary bitsets are moved into owning leaves and
+// the other bitsets and views are referenced.
+template <forwarded_operand T>
+auto as_bitset_expression(T&& operand) {
+  using type = std::remove_cvref_t<T>;
+  if constexpr (bitset_expression_type<type>) {
+    return type(std::forward<T>(operand));
+  } else if constexpr (temporary_bitset<T>) {
+    return bitset_owning_operand<type>(std::forward<T>(operand));
+  } else {
+    return bitset_operand(operand);
+  }
+}
+
+template <forwarded_operand Left, forwarded_operand Right>
+auto operator&(Left&& lhs, Right&& rhs) {
+  auto left = as_bitset_expression(std::forward<Left>(lhs));
+  auto right = as_bitset_expression(std::forward<Right>(rhs));
+  return bitset_binary_expression<std::bit_and<>, decltype(left), decltype(right)>(left, right);
+}
+
+template <forwarded_operand Left, forwarded_operand Right>
+auto operator|(Left&& lhs, Right&& rhs) {
+  auto left = as_bitset_expression(std::forward<Left>(lhs));
+  auto right = as_bitset_expression(std::forward<Right>(rhs));
+  return bitset_binary_expression<std::bit_or<>, decltype(left), decltype(right)>(left, right);
+}
+
+template <forwarded_operand Left, forwarded_operand Right>
+auto operator^(Left&& lhs, Right&& rhs) {
+  auto left = as_bitset_expression(std::forward<Left>(lhs));
+  auto right = as_bitset_expression(std::forward<Right>(rhs));
+  return bitset_binary_expression<std::bit_xor<>, decltype(left), decltype(right)>(left, right);
+}
+
+template <forwarded_operand T>
+auto operator~(T&& operand) {
+  auto expr = as_bitset_expression(std::forward<T>(operand));
+  return bitset_not_expression<decltype(expr)>(expr);
+}
+
+template <forwarded_operand T>
+auto operator<<(T&& operand, std::size_t count) {
+  auto expr = as_bitset_expression(std::forward<T>(operand));
+  return bitset_resize_expression<decltype(expr)>(expr, expr.size() + count);
+}
+
+template <forwarded_operand T>
+auto operator>>(T&& operand, std::size_t count) {
+  auto expr = as_bitset_expression(std::forward<T>(operand));
+  return bitset_resize_expression<decltype(expr)>(expr, expr.size() - std::min(count, expr.size()));
+}
+
+template <bitset_operand_type Left, bitset_operand_type Right>
+  requires (bitset_expression_type<Left> || bitset_expression_type<Right>)
+bool operator==(const Left& lhs, const Right& rhs) {
+  auto left = as_bitset_expression(lhs);
+  auto right = as_bitset_expression(rhs);
+  if (left.size() != right.size()) {
+    return false;
+  }
+  for (std::size_t ind = 0; ind < left.words(); ++ind) {
+    if (left.word(ind) != right.word(ind)) {
+      return false;
+    }
+  }
+  return true;
+}
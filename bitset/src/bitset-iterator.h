@@ -19,104 +19,104 @@ public:
   using const_reference = bitset_reference<const T>;
   using pointer = void;
 
-  bitset_iterator() = default;
+  constexpr bitset_iterator() = default;
 
-  bitset_iterator(const bitset_iterator& other) = default;
+  constexpr bitset_iterator(const bitset_iterator& other) = default;
 
-  bitset_iterator& operator=(const bitset_iterator& other) = default;
+  constexpr bitset_iterator& operator=(const bitset_iterator& other) = default;
 
-  operator bitset_iterator<const T>() const {
+  constexpr operator bitset_iterator<const T>() const {
     return {data_, index_};
   }
 
-  reference operator*() const {
+  constexpr reference operator*() const {
     return reference(data_[index_ / constants::word_size_bits], index_ % constants::word_size_bits);
   }
 
-  bitset_iterator& operator++() {
+  constexpr bitset_iterator& operator++() {
     index_++;
     return *this;
   }
 
-  bitset_iterator operator++(int) {
+  constexpr bitset_iterator operator++(int) {
     bitset_iterator tmp = *this;
     ++*this;
     return tmp;
   }
 
-  bitset_iterator& operator--() {
+  constexpr bitset_iterator& operator--() {
     index_--;
     return *this;
   }
 
-  bitset_iterator operator--(int) {
+  constexpr bitset_iterator operator--(int) {
     bitset_iterator tmp = *this;
     --*this;
     return tmp;
   }
 
-  bitset_iterator& operator+=(difference_type n) {
+  constexpr bitset_iterator& operator+=(difference_type n) {
     index_ += static_cast<std::size_t>(n);
     return *this;
   }
 
-  bitset_iterator& operator-=(difference_type n) {
+  constexpr bitset_iterator& operator-=(difference_type n) {
     index_ -= static_cast<std::size_t>(n);
     return *this;
   }
 
-  bitset_iterator operator+(difference_type n) const {
+  constexpr bitset_iterator operator+(difference_type n) const {
     bitset_iterator tmp = *this;
     tmp.index_ += static_cast<std::size_t>(n);
     return tmp;
   }
 
-  friend bitset_iterator operator+(difference_type n, const bitset_iterator& it) {
+  friend constexpr bitset_iterator operator+(difference_type n, const bitset_iterator& it) {
     return it + n;
   }
 
-  bitset_iterator operator-(difference_type n) const {
+  constexpr bitset_iterator operator-(difference_type n) const {
     bitset_iterator tmp = *this;
     tmp.index_ -= static_cast<std::size_t>(n);
     return tmp;
   }
 
-  friend difference_type operator-(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr difference_type operator-(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     return static_cast<difference_type>(lhs.index_ - rhs.index_);
   }
 
-  reference operator[](difference_type n) const {
+  constexpr reference operator[](difference_type n) const {
     return *(*this + n);
   }
 
-  friend bool operator==(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr bool operator==(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     return lhs.index_ == rhs.index_;
   }
 
-  friend bool operator!=(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr bool operator!=(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     return !(lhs == rhs);
   }
 
-  friend bool operator<=(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr bool operator<=(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     return lhs.index_ <= rhs.index_;
   }
 
-  friend bool operator<(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr bool operator<(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     return lhs.index_ < rhs.index_;
   }
 
-  friend bool operator>=(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr bool operator>=(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     return lhs.index_ >= rhs.index_;
   }
 
-  friend bool operator>(const bitset_iterator& lhs, const bitset_iterator& rhs) {
+  friend constexpr bool operator>(const bitset_iterator& lhs, const bitset_iterator& rhs) {
     return lhs.index_ > rhs.index_;
   }
 
-  ~bitset_iterator() = default;
+  constexpr ~bitset_iterator() = default;
 
 private:
-  T get(std::size_t size) const {
+  constexpr T get(std::size_t size) const {
     std::size_t shift = index_ % constants::word_size_bits;
     if (size <= constants::word_size_bits - shift) {
       return (
@@ -132,7 +132,7 @@ private:
     );
   }
 
-  void set(T value, std::size_t size) const
+  constexpr void set(T value, std::size_t size) const
     requires (!std::is_const_v<T>)
   {
     std::size_t shift = index_ % constants::word_size_bits;
@@ -150,16 +150,28 @@ private:
     }
   }
 
-  bitset_iterator(T* data, std::size_t index)
+  constexpr T* word() const {
+    return data_ + index_ / constants::word_size_bits;
+  }
+
+  constexpr std::size_t offset() const {
+    return index_ % constants::word_size_bits;
+  }
+
+  constexpr bitset_iterator(T* data, std::size_t index)
       : data_(data)
       , index_(index) {}
 
   friend class bitset;
+  friend class bitset_operand;
+  friend class bitset_parallel;
+  template <std::size_t N>
+  friend class static_bitset;
   template <typename T1>
   friend class bitset_view;
   template <typename T2>
   friend class bitset_iterator;
 
-  T* data_;
-  std::size_t index_;
+  T* data_ = nullptr;
+  std::size_t index_ = 0;
 };
@@ -0,0 +1,436 @@
+#include "bitset-kernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define BITSET_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace kernels {
+namespace {
+struct kernel_table {
+  void (*bit_and)(word_type*, const word_type*, std::size_t);
+  void (*bit_or)(word_type*, const word_type*, std::size_t);
+  void (*bit_xor)(word_type*, const word_type*, std::size_t);
+  void (*bit_not)(word_type*, std::size_t);
+  std::size_t (*popcount)(const word_type*, std::size_t);
+  bool (*all)(const word_type*, std::size_t);
+  bool (*any)(const word_type*, std::size_t);
+  bool (*equal)(const word_type*, const word_type*, std::size_t);
+  void (*parse)(word_type*, const char*, std::size_t);
+  void (*format)(char*, const word_type*, std::size_t);
+};
+
+constexpr std::size_t byte_bits = 8;
+
+namespace scalar {
+void bit_and(word_type* dst, const word_type* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] &= src[i];
+  }
+}
+
+void bit_or(word_type* dst, const word_type* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] |= src[i];
+  }
+}
+
+void bit_xor(word_type* dst, const word_type* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] ^= src[i];
+  }
+}
+
+void bit_not(word_type* dst, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] = ~dst[i];
+  }
+}
+
+std::size_t popcount(const word_type* data, std::size_t count) {
+  std::size_t ans = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    ans += std::popcount(data[i]);
+  }
+  return ans;
+}
+
+bool all(const word_type* data, std::size_t count) {
+  return std::all_of(data, data + count, [](word_type value) { return value == constants::max; });
+}
+
+bool any(const word_type* data, std::size_t count) {
+  return std::any_of(data, data + count, [](word_type value) { return value != 0; });
+}
+
+bool equal(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  return std::equal(lhs, lhs + count, rhs);
+}
+
+word_type parse_bits(const char* src, std::size_t bits) {
+  word_type ans = 0;
+  for (std::size_t i = 0; i < bits; ++i) {
+    ans |= static_cast<word_type>(src[i] == '1') << i;
+  }
+  return ans;
+}
+
+void format_bits(char* dst, word_type value, std::size_t bits) {
+  for (std::size_t i = 0; i < bits; ++i) {
+    dst[i] = ((value >> i) & 1) ? '1' : '0';
+  }
+}
+
+// SWAR over eight characters: bytes equal to '1' are found without carries between bytes,
+// then their high bits are gathered into one byte with a multiplication.
+std::uint8_t parse_byte(const char* src) {
+  constexpr std::uint64_t low_bits = 0x7f7f7f7f7f7f7f7f;
+  std::uint64_t chars;
+  std::memcpy(&chars, src, sizeof(chars));
+  chars ^= 0x3131313131313131;
+  std::uint64_t ones = ~(((chars & low_bits) + low_bits) | chars) & ~low_bits;
+  return static_cast<std::uint8_t>(((ones >> 7) * 0x0102040810204080) >> 56);
+}
+
+void format_byte(char* dst, std::uint8_t value) {
+  std::uint64_t chars = (static_cast<std::uint64_t>(value) * 0x0101010101010101) & 0x8040201008040201;
+  chars = (((chars + 0x7f7f7f7f7f7f7f7f) >> 7) & 0x0101010101010101) + 0x3030303030303030;
+  std::memcpy(dst, &chars, sizeof(chars));
+}
+
+void parse(word_type* dst, const char* src, std::size_t bits) {
+  std::size_t i = 0;
+  if constexpr (std::endian::native == std::endian::little) {
+    for (; i + constants::word_size_bits <= bits; i += constants::word_size_bits) {
+      word_type value = 0;
+      for (std::size_t j = 0; j < constants::word_size_bits; j += byte_bits) {
+        value |= static_cast<word_type>(parse_byte(src + i + j)) << j;
+      }
+      dst[i / constants::word_size_bits] = value;
+    }
+  }
+  for (; i < bits; i += constants::word_size_bits) {
+    dst[i / constants::word_size_bits] = parse_bits(src + i, std::min(constants::word_size_bits, bits - i));
+  }
+}
+
+void format(char* dst, const word_type* src, std::size_t bits) {
+  std::size_t i = 0;
+  if constexpr (std::endian::native == std::endian::little) {
+    for (; i + constants::word_size_bits <= bits; i += constants::word_size_bits) {
+      for (std::size_t j = 0; j < constants::word_size_bits; j += byte_bits) {
+        format_byte(dst + i + j, static_cast<std::uint8_t>(src[i / constants::word_size_bits] >> j));
+      }
+    }
+  }
+  for (; i < bits; i += constants::word_size_bits) {
+    format_bits(dst + i, src[i / constants::word_size_bits], std::min(constants::word_size_bits, bits - i));
+  }
+}
+
+constexpr kernel_table table = {bit_and, bit_or, bit_xor, bit_not, popcount, all, any, equal, parse, format};
+} // namespace scalar
+
+#ifdef BITSET_X86_KERNELS
+namespace avx2 {
+constexpr std::size_t step = sizeof(__m256i) / sizeof(word_type);
+
+__attribute__((target("avx2"))) __m256i load(const word_type* ptr) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+__attribute__((target("avx2"))) void store(word_type* ptr, __m256i value) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), value);
+}
+
+__attribute__((target("avx2"))) void bit_and(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm256_and_si256(load(dst + i), load(src + i)));
+  }
+  scalar::bit_and(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx2"))) void bit_or(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm256_or_si256(load(dst + i), load(src + i)));
+  }
+  scalar::bit_or(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx2"))) void bit_xor(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm256_xor_si256(load(dst + i), load(src + i)));
+  }
+  scalar::bit_xor(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx2"))) void bit_not(word_type* dst, std::size_t count) {
+  const __m256i ones = _mm256_set1_epi8(-1);
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm256_xor_si256(load(dst + i), ones));
+  }
+  scalar::bit_not(dst + i, count - i);
+}
+
+// Nibble lookup popcount: every byte is split into two nibbles which are counted
+// with a shuffle, then byte counts are summed into 64-bit lanes.
+__attribute__((target("avx2"))) std::size_t popcount(const word_type* data, std::size_t count) {
+  const __m256i lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+  );
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i sum = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    __m256i value = load(data + i);
+    __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(value, low_mask));
+    __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(value, 4), low_mask));
+    sum = _mm256_add_epi64(sum, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+  }
+  word_type lanes[step];
+  store(lanes, sum);
+  return scalar::popcount(data + i, count - i) + static_cast<std::size_t>(std::accumulate(lanes, lanes + step, 0ULL));
+}
+
+__attribute__((target("avx2"))) bool all(const word_type* data, std::size_t count) {
+  const __m256i ones = _mm256_set1_epi8(-1);
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    if (!_mm256_testc_si256(load(data + i), ones)) {
+      return false;
+    }
+  }
+  return scalar::all(data + i, count - i);
+}
+
+__attribute__((target("avx2"))) bool any(const word_type* data, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    __m256i value = load(data + i);
+    if (!_mm256_testz_si256(value, value)) {
+      return true;
+    }
+  }
+  return scalar::any(data + i, count - i);
+}
+
+__attribute__((target("avx2"))) bool equal(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    __m256i diff = _mm256_xor_si256(load(lhs + i), load(rhs + i));
+    if (!_mm256_testz_si256(diff, diff)) {
+      return false;
+    }
+  }
+  return scalar::equal(lhs + i, rhs + i, count - i);
+}
+
+// 32 characters per step: bytes equal to '1' are compared at once and their mask is the word half.
+__attribute__((target("avx2"))) void parse(word_type* dst, const char* src, std::size_t bits) {
+  constexpr std::size_t half = constants::word_size_bits / 2;
+  const __m256i ones = _mm256_set1_epi8('1');
+  std::size_t i = 0;
+  for (; i + constants::word_size_bits <= bits; i += constants::word_size_bits) {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + half));
+    auto low_mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, ones)));
+    auto high_mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, ones)));
+    dst[i / constants::word_size_bits] = static_cast<word_type>(low_mask) | (static_cast<word_type>(high_mask) << half);
+  }
+  scalar::parse(dst + i / constants::word_size_bits, src + i, bits - i);
+}
+
+// Every byte of a broadcast 32-bit half is copied to eight lanes and tested against one bit each.
+__attribute__((target("avx2"))) __m256i format_half(std::uint32_t value) {
+  const __m256i spread = _mm256_setr_epi8(
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3
+  );
+  const __m256i select = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201));
+  __m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(value)), spread);
+  __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, select), select);
+  return _mm256_sub_epi8(_mm256_set1_epi8('0'), set);
+}
+
+__attribute__((target("avx2"))) void format(char* dst, const word_type* src, std::size_t bits) {
+  constexpr std::size_t half = constants::word_size_bits / 2;
+  std::size_t i = 0;
+  for (; i + constants::word_size_bits <= bits; i += constants::word_size_bits) {
+    word_type value = src[i / constants::word_size_bits];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), format_half(static_cast<std::uint32_t>(value)));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i + half),
+        format_half(static_cast<std::uint32_t>(value >> half))
+    );
+  }
+  scalar::format(dst + i, src + i / constants::word_size_bits, bits - i);
+}
+
+constexpr kernel_table table = {bit_and, bit_or, bit_xor, bit_not, popcount, all, any, equal, parse, format};
+} // namespace avx2
+
+namespace avx512 {
+constexpr std::size_t step = sizeof(__m512i) / sizeof(word_type);
+
+__attribute__((target("avx512f"))) __m512i load(const word_type* ptr) {
+  return _mm512_loadu_si512(ptr);
+}
+
+__attribute__((target("avx512f"))) void store(word_type* ptr, __m512i value) {
+  _mm512_storeu_si512(ptr, value);
+}
+
+__attribute__((target("avx512f"))) void bit_and(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm512_and_si512(load(dst + i), load(src + i)));
+  }
+  scalar::bit_and(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx512f"))) void bit_or(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm512_or_si512(load(dst + i), load(src + i)));
+  }
+  scalar::bit_or(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx512f"))) void bit_xor(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm512_xor_si512(load(dst + i), load(src + i)));
+  }
+  scalar::bit_xor(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx512f"))) void bit_not(word_type* dst, std::size_t count) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm512_xor_si512(load(dst + i), ones));
+  }
+  scalar::bit_not(dst + i, count - i);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq"))) std::size_t popcount(const word_type* data, std::size_t count) {
+  __m512i sum = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(load(data + i)));
+  }
+  word_type lanes[step];
+  store(lanes, sum);
+  return scalar::popcount(data + i, count - i) + static_cast<std::size_t>(std::accumulate(lanes, lanes + step, 0ULL));
+}
+
+__attribute__((target("avx512f"))) bool all(const word_type* data, std::size_t count) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    if (_mm512_cmpneq_epi64_mask(load(data + i), ones) != 0) {
+      return false;
+    }
+  }
+  return scalar::all(data + i, count - i);
+}
+
+__attribute__((target("avx512f"))) bool any(const word_type* data, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    __m512i value = load(data + i);
+    if (_mm512_test_epi64_mask(value, value) != 0) {
+      return true;
+    }
+  }
+  return scalar::any(data + i, count - i);
+}
+
+__attribute__((target("avx512f"))) bool equal(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    if (_mm512_cmpneq_epi64_mask(load(lhs + i), load(rhs + i)) != 0) {
+      return false;
+    }
+  }
+  return scalar::equal(lhs + i, rhs + i, count - i);
+}
+
+constexpr kernel_table table = {
+    bit_and, bit_or, bit_xor, bit_not, popcount, all, any, equal, avx2::parse, avx2::format
+};
+} // namespace avx512
+#endif
+
+kernel_table select_table() {
+#ifdef BITSET_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq")) {
+    return avx512::table;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return avx2::table;
+  }
+#endif
+  return scalar::table;
+}
+
+const kernel_table& table() {
+  static const kernel_table selected = select_table();
+  return selected;
+}
+} // namespace
+
+namespace dispatch {
+void bit_and(word_type* dst, const word_type* src, std::size_t count) {
+  table().bit_and(dst, src, count);
+}
+
+void bit_or(word_type* dst, const word_type* src, std::size_t count) {
+  table().bit_or(dst, src, count);
+}
+
+void bit_xor(word_type* dst, const word_type* src, std::size_t count) {
+  table().bit_xor(dst, src, count);
+}
+
+void bit_not(word_type* dst, std::size_t count) {
+  table().bit_not(dst, count);
+}
+
+std::size_t popcount(const word_type* data, std::size_t count) {
+  return table().popcount(data, count);
+}
+
+bool all(const word_type* data, std::size_t count) {
+  return table().all(data, count);
+}
+
+bool any(const word_type* data, std::size_t count) {
+  return table().any(data, count);
+}
+
+bool equal(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  return table().equal(lhs, rhs, count);
+}
+
+} // namespace dispatch
+
+void parse(word_type* dst, const char* src, std::size_t bits) {
+  table().parse(dst, src, bits);
+}
+
+void format(char* dst, const word_type* src, std::size_t bits) {
+  table().format(dst, src, bits);
+}
+} // namespace kernels
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "bitset-constants.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
+// Loops over whole words. The implementation is chosen once at runtime
+// from the instruction sets supported by the CPU, plain loops are the fallback.
+// During constant evaluation the word loops are written inline.
+namespace kernels {
+using constants::word_type;
+
+namespace dispatch {
+void bit_and(word_type* dst, const word_type* src, std::size_t count);
+void bit_or(word_type* dst, const word_type* src, std::size_t count);
+void bit_xor(word_type* dst, const word_type* src, std::size_t count);
+void bit_not(word_type* dst, std::size_t count);
+
+std::size_t popcount(const word_type* data, std::size_t count);
+bool all(const word_type* data, std::size_t count);
+bool any(const word_type* data, std::size_t count);
+bool equal(const word_type* lhs, const word_type* rhs, std::size_t count);
+} // namespace dispatch
+
+constexpr void bit_and(word_type* dst, const word_type* src, std::size_t count) {
+  if (std::is_constant_evaluated()) {
+    for (std::size_t i = 0; i < count; ++i) {
+      dst[i] &= src[i];
+    }
+  } else {
+    dispatch::bit_and(dst, src, count);
+  }
+}
+
+constexpr void bit_or(word_type* dst, const word_type* src, std::size_t count) {
+  if (std::is_constant_evaluated()) {
+    for (std::size_t i = 0; i < count; ++i) {
+      dst[i] |= src[i];
+    }
+  } else {
+    dispatch::bit_or(dst, src, count);
+  }
+}
+
+constexpr void bit_xor(word_type* dst, const word_type* src, std::size_t count) {
+  if (std::is_constant_evaluated()) {
+    for (std::size_t i = 0; i < count; ++i) {
+      dst[i] ^= src[i];
+    }
+  } else {
+    dispatch::bit_xor(dst, src, count);
+  }
+}
+
+constexpr void bit_not(word_type* dst, std::size_t count) {
+  if (std::is_constant_evaluated()) {
+    for (std::size_t i = 0; i < count; ++i) {
+      dst[i] = ~dst[i];
+    }
+  } else {
+    dispatch::bit_not(dst, count);
+  }
+}
+
+constexpr std::size_t popcount(const word_type* data, std::size_t count) {
+  if (std::is_constant_evaluated()) {
+    std::size_t ans = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      ans += static_cast<std::size_t>(std::popcount(data[i]));
+    }
+    return ans;
+  }
+  return dispatch::popcount(data, count);
+}
+
+constexpr bool all(const word_type* data, std::size_t count) {
+  if (std::is_constant_evaluated()) {
+    return std::all_of(data, data + count, [](word_type value) { return value == constants::max; });
+  }
+  return dispatch::all(data, count);
+}
+
+constexpr bool any(const word_type* data, std::size_t count) {
+  if (std::is_constant_evaluated()) {
+    return std::any_of(data, data + count, [](word_type value) { return value != 0; });
+  }
+  return dispatch::any(data, count);
+}
+
+constexpr bool equal(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  if (std::is_constant_evaluated()) {
+    return std::equal(lhs, lhs + count, rhs);
+  }
+  return dispatch::equal(lhs, rhs, count);
+}
+
+// Text conversion, character i corresponds to bit i; '1' sets a bit, any other character clears it.
+// parse() overwrites the ceil(bits / 64) destination words, format() writes exactly `bits` characters.
+void parse(word_type* dst, const char* src, std::size_t bits);
+void format(char* dst, const word_type* src, std::size_t bits);
+} // namespace kernels
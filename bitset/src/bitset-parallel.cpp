@@ -0,0 +1,109 @@
+#include "bitset-parallel.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+bitset_parallel::bitset_parallel()
+    : bitset_parallel(std::thread::hardware_concurrency()) {}
+
+bitset_parallel::bitset_parallel(std::size_t threads)
+    : threads_(std::max<std::size_t>(threads, 1)) {}
+
+std::size_t bitset_parallel::threads() const {
+  return threads_;
+}
+
+void bitset_parallel::bit_and(const view& dst, const const_view& src) const {
+  for_each_part(dst, [&](std::size_t, std::size_t pos, std::size_t count) {
+    view vw = dst;
+    vw.subview(pos, count) &= src.subview(pos, count);
+  });
+}
+
+void bitset_parallel::bit_or(const view& dst, const const_view& src) const {
+  for_each_part(dst, [&](std::size_t, std::size_t pos, std::size_t count) {
+    view vw = dst;
+    vw.subview(pos, count) |= src.subview(pos, count);
+  });
+}
+
+void bitset_parallel::bit_xor(const view& dst, const const_view& src) const {
+  for_each_part(dst, [&](std::size_t, std::size_t pos, std::size_t count) {
+    view vw = dst;
+    vw.subview(pos, count) ^= src.subview(pos, count);
+  });
+}
+
+void bitset_parallel::flip(const view& dst) const {
+  for_each_part(dst, [&](std::size_t, std::size_t pos, std::size_t count) {
+    view vw = dst;
+    vw.subview(pos, count).flip();
+  });
+}
+
+std::size_t bitset_parallel::count(const const_view& vw) const {
+  std::vector<std::size_t> counts(threads_);
+  for_each_part(vw, [&](std::size_t part, std::size_t pos, std::size_t count) {
+    counts[part] = vw.subview(pos, count).count();
+  });
+  return std::accumulate(counts.begin(), counts.end(), std::size_t(0));
+}
+
+bool bitset_parallel::all(const const_view& vw) const {
+  std::vector<char> results(threads_, true);
+  for_each_part(vw, [&](std::size_t part, std::size_t pos, std::size_t count) {
+    results[part] = vw.subview(pos, count).all();
+  });
+  return std::all_of(results.begin(), results.end(), [](char result) { return result; });
+}
+
+bool bitset_parallel::any(const const_view& vw) const {
+  std::vector<char> results(threads_, false);
+  for_each_part(vw, [&](std::size_t part, std::size_t pos, std::size_t count) {
+    results[part] = vw.subview(pos, count).any();
+  });
+  return std::any_of(results.begin(), results.end(), [](char result) { return result; });
+}
+
+bool bitset_parallel::equal(const const_view& lhs, const const_view& rhs) const {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  std::vector<char> results(threads_, true);
+  for_each_part(lhs, [&](std::size_t part, std::size_t pos, std::size_t count) {
+    results[part] = lhs.subview(pos, count) == rhs.subview(pos, count);
+  });
+  return std::all_of(results.begin(), results.end(), [](char result) { return result; });
+}
+
+// Calls func(part, pos, count) for consecutive parts of the view, the first part on the calling thread.
+// The parts are cut where a cache line starts in memory, the storage itself is only word-aligned.
+// Workers are joined when they go out of scope, also if starting one or `func` on this thread throws.
+template <typename Func>
+void bitset_parallel::for_each_part(const const_view& vw, Func func) const {
+  std::size_t parts = std::min(threads_, vw.size() / min_part_bits);
+  if (parts <= 1) {
+    func(0, 0, vw.size());
+    return;
+  }
+  auto address = reinterpret_cast<std::uintptr_t>(vw.begin().word());
+  std::size_t offset = address % (cache_line_bits / CHAR_BIT) * CHAR_BIT + vw.begin().offset();
+  std::vector<std::size_t> bounds(parts + 1, vw.size());
+  bounds[0] = 0;
+  for (std::size_t part = 1; part < parts; ++part) {
+    std::size_t pos = vw.size() / parts * part + offset;
+    bounds[part] = pos - pos % cache_line_bits - offset;
+  }
+
+  std::vector<std::jthread> workers;
+  workers.reserve(parts - 1);
+  for (std::size_t part = 1; part < parts; ++part) {
+    workers.emplace_back(func, part, bounds[part], bounds[part + 1] - bounds[part]);
+  }
+  func(0, bounds[0], bounds[1] - bounds[0]);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+
+// Runs bulk operations over large views on several threads. The views are split at 64-byte
+// boundaries of the addresses of the underlying storage, so the threads write disjoint cache lines.
+// Views shorter than a few parallel parts are processed on the calling thread.
+class bitset_parallel {
+public:
+  using view = bitset::view;
+  using const_view = bitset::const_view;
+
+  // Uses the number of hardware threads.
+  bitset_parallel();
+  explicit bitset_parallel(std::size_t threads);
+
+  std::size_t threads() const;
+
+  // The operands of the binary operations must have the same size.
+  void bit_and(const view& dst, const const_view& src) const;
+  void bit_or(const view& dst, const const_view& src) const;
+  void bit_xor(const view& dst, const const_view& src) const;
+  void flip(const view& dst) const;
+
+  std::size_t count(const const_view& vw) const;
+  bool all(const const_view& vw) const;
+  bool any(const const_view& vw) const;
+  bool equal(const const_view& lhs, const const_view& rhs) const;
+
+private:
+  static constexpr std::size_t cache_line_bits = 512;
+  static constexpr std::size_t min_part_bits = std::size_t(1) << 20;
+
+  template <typename Func>
+  void for_each_part(const const_view& vw, Func func) const;
+
+  std::size_t threads_;
+};
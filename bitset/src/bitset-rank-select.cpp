@@ -0,0 +1,118 @@
+#include "bitset-rank-select.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+std::size_t select_in_word(constants::word_type value, std::size_t rank) {
+  std::size_t pos = 0;
+  for (std::size_t width = constants::word_size_bits / 2; width > 0; width /= 2) {
+    constants::word_type low = value & ((constants::one << width) - 1);
+    auto count = static_cast<std::size_t>(std::popcount(low));
+    if (rank >= count) {
+      rank -= count;
+      value >>= width;
+      pos += width;
+    } else {
+      value = low;
+    }
+  }
+  return pos;
+}
+} // namespace
+
+bitset_rank_select::bitset_rank_select() {
+  build();
+}
+
+bitset_rank_select::bitset_rank_select(const const_view& vw)
+    : view_(vw) {
+  build();
+}
+
+void bitset_rank_select::assign(const const_view& vw) {
+  view_ = vw;
+  invalidate();
+}
+
+void bitset_rank_select::invalidate() {
+  build();
+}
+
+std::size_t bitset_rank_select::size() const {
+  return view_.size();
+}
+
+std::size_t bitset_rank_select::rank1(std::size_t pos) const {
+  pos = std::min(pos, size());
+  return block_rank(pos / block_bits) + count_bits(pos - pos % block_bits, pos);
+}
+
+std::size_t bitset_rank_select::rank0(std::size_t pos) const {
+  return std::min(pos, size()) - rank1(pos);
+}
+
+std::size_t bitset_rank_select::select1(std::size_t rank) const {
+  if (rank >= ones_) {
+    return npos;
+  }
+  std::size_t first = samples_[rank / select_sample];
+  std::size_t last = (rank / select_sample + 1 < samples_.size()) ? samples_[rank / select_sample + 1] + 1
+                                                                   : blocks_.size();
+  while (last - first > 1) {
+    std::size_t middle = first + (last - first) / 2;
+    if (block_rank(middle) <= rank) {
+      first = middle;
+    } else {
+      last = middle;
+    }
+  }
+  rank -= block_rank(first);
+  std::size_t pos = first * block_bits;
+  while (true) {
+    std::size_t count = std::min(constants::word_size_bits, size() - pos);
+    constants::word_type value = view_.get_word(pos, count);
+    auto ones = static_cast<std::size_t>(std::popcount(value));
+    if (rank < ones) {
+      return pos + select_in_word(value, rank);
+    }
+    rank -= ones;
+    pos += count;
+  }
+}
+
+void bitset_rank_select::build() {
+  superblocks_.assign(size() / superblock_bits + 1, 0);
+  blocks_.assign(size() / block_bits + 1, 0);
+  samples_.clear();
+
+  std::size_t ones = 0;
+  for (std::size_t block = 0; block < blocks_.size(); ++block) {
+    std::size_t pos = block * block_bits;
+    if (pos % superblock_bits == 0) {
+      superblocks_[pos / superblock_bits] = ones;
+    }
+    blocks_[block] = static_cast<std::uint16_t>(ones - superblocks_[pos / superblock_bits]);
+    std::size_t block_ones = count_bits(pos, std::min(pos + block_bits, size()));
+    while (samples_.size() * select_sample < ones + block_ones) {
+      samples_.push_back(block);
+    }
+    ones += block_ones;
+  }
+  ones_ = ones;
+}
+
+std::size_t bitset_rank_select::block_rank(std::size_t block) const {
+  return superblocks_[block * block_bits / superblock_bits] + blocks_[block];
+}
+
+std::size_t bitset_rank_select::count_bits(std::size_t first, std::size_t last) const {
+  std::size_t ans = 0;
+  for (std::size_t ind = first; ind < last; ind += constants::word_size_bits) {
+    std::size_t count = std::min(constants::word_size_bits, last - ind);
+    ans += static_cast<std::size_t>(std::popcount(view_.get_word(ind, count)));
+  }
+  return ans;
+}
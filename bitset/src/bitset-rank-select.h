@@ -0,0 +1,48 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Two-level rank directory with sampled select over a view.
+// The view is not owned and the directory is built at construction, so const queries
+// may run concurrently. After changing the viewed bits call invalidate() before the
+// next query, it rebuilds the directory.
+class bitset_rank_select {
+public:
+  using const_view = bitset::const_view;
+
+  static constexpr std::size_t npos = -1;
+
+  bitset_rank_select();
+  explicit bitset_rank_select(const const_view& vw);
+
+  void assign(const const_view& vw);
+  void invalidate();
+
+  std::size_t size() const;
+
+  // Number of set bits in [0, pos).
+  std::size_t rank1(std::size_t pos) const;
+  std::size_t rank0(std::size_t pos) const;
+
+  // Position of the set bit with the given zero-based rank, or npos.
+  std::size_t select1(std::size_t rank) const;
+
+private:
+  static constexpr std::size_t block_bits = 512;
+  static constexpr std::size_t superblock_bits = 65536;
+  static constexpr std::size_t select_sample = 8192;
+
+  void build();
+  std::size_t block_rank(std::size_t block) const;
+  std::size_t count_bits(std::size_t first, std::size_t last) const;
+
+  const_view view_;
+  std::size_t ones_ = 0;
+  std::vector<std::uint64_t> superblocks_;
+  std::vector<std::uint16_t> blocks_;
+  std::vector<std::size_t> samples_;
+};
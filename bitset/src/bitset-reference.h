@@ -8,19 +8,19 @@ class bitset_reference {
 public:
   bitset_reference() = delete;
 
-  bitset_reference(const bitset_reference& other) = default;
+  constexpr bitset_reference(const bitset_reference& other) = default;
 
-  bitset_reference& operator=(const bitset_reference& other) = default;
+  constexpr bitset_reference& operator=(const bitset_reference& other) = default;
 
-  operator bitset_reference<const T>() const {
+  constexpr operator bitset_reference<const T>() const {
     return {element_, index_};
   }
 
-  operator bool() const {
+  constexpr operator bool() const {
     return static_cast<bool>((element_ >> index_) & static_cast<T>(1));
   }
 
-  bitset_reference& operator=(bool val)
+  constexpr bitset_reference& operator=(bool val)
     requires (!std::is_const_v<T>)
   {
     if (*this != val) {
@@ -29,17 +29,17 @@ public:
     return *this;
   }
 
-  bitset_reference& flip()
+  constexpr bitset_reference& flip()
     requires (!std::is_const_v<T>)
   {
     element_ ^= (static_cast<T>(1) << index_);
     return *this;
   }
 
-  ~bitset_reference() = default;
+  constexpr ~bitset_reference() = default;
 
 private:
-  bitset_reference(T& element, std::size_t index)
+  constexpr bitset_reference(T& element, std::size_t index)
       : element_(element)
       , index_(index) {}
 
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "bitset-constants.h"
+#include "bitset-view.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+
+// Range of the indices of set bits in a view, scanned one word at a time.
+template <typename T>
+class bitset_set_bits {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::size_t;
+    using reference = std::size_t;
+    using pointer = void;
+
+    iterator() = default;
+
+    reference operator*() const {
+      return pos_ + static_cast<std::size_t>(std::countr_zero(word_));
+    }
+
+    iterator& operator++() {
+      word_ &= word_ - 1;
+      skip_empty();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const iterator& lhs, const iterator& rhs) {
+      return lhs.pos_ == rhs.pos_ && lhs.word_ == rhs.word_;
+    }
+
+    friend bool operator!=(const iterator& lhs, const iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+  private:
+    iterator(const bitset_view<T>& view, std::size_t pos)
+        : view_(view)
+        , pos_(pos) {
+      if (pos_ < view_.size()) {
+        word_ = view_.get_word(pos_, chunk_size());
+        skip_empty();
+      }
+    }
+
+    std::size_t chunk_size() const {
+      return std::min(constants::word_size_bits, view_.size() - pos_);
+    }
+
+    void skip_empty() {
+      while (word_ == 0 && pos_ < view_.size()) {
+        pos_ += chunk_size();
+        if (pos_ < view_.size()) {
+          word_ = view_.get_word(pos_, chunk_size());
+        }
+      }
+    }
+
+    friend class bitset_set_bits;
+
+    bitset_view<T> view_;
+    std::size_t pos_ = 0;
+    constants::word_type word_ = 0;
+  };
+
+  explicit bitset_set_bits(const bitset_view<T>& view)
+      : view_(view) {}
+
+  iterator begin() const {
+    return {view_, 0};
+  }
+
+  iterator end() const {
+    return {view_, view_.size()};
+  }
+
+private:
+  bitset_view<T> view_;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bitset-constants.h"
+#include "bitset-kernels.h"
 
 #include <algorithm>
 #include <bit>
@@ -9,6 +10,12 @@
 #include <string>
 #include <type_traits>
 
+template <typename T>
+class bitset_set_bits;
+
+template <typename Derived>
+class bitset_expression;
+
 template <typename T>
 class bitset_view {
 public:
@@ -21,113 +28,220 @@ public:
   using view = bitset_view<word_type>;
   using const_view = bitset_view<const word_type>;
 
-  bitset_view() = default;
+  constexpr bitset_view() = default;
 
-  bitset_view(iterator left, iterator right)
+  constexpr bitset_view(iterator left, iterator right)
       : left_(left)
       , right_(right) {}
 
-  bitset_view(const bitset_view& other) = default;
+  // Non-owning view over `size` bits stored in external words, e.g. a memory-mapped file,
+  // using the same layout as bitset::data().
+  constexpr bitset_view(word_type* data, std::size_t size)
+      : left_(data, 0)
+      , right_(data, size) {}
+
+  constexpr bitset_view(const bitset_view& other) = default;
 
-  bitset_view& operator=(const bitset_view& other) = default;
+  constexpr bitset_view& operator=(const bitset_view& other) = default;
 
-  operator const_view() const {
+  constexpr operator const_view() const {
     return {left_, right_};
   }
 
-  void swap(view& other) {
+  constexpr void swap(view& other) {
     std::swap(left_, other.left_);
     std::swap(right_, other.right_);
   }
 
-  std::size_t size() const {
+  constexpr std::size_t size() const {
     return static_cast<std::size_t>(right_ - left_);
   }
 
-  bool empty() const {
+  constexpr bool empty() const {
     return size() == 0;
   }
 
-  reference operator[](std::size_t index) const {
+  constexpr reference operator[](std::size_t index) const {
     return *(begin() + static_cast<ptrdiff_t>(index));
   }
 
-  iterator begin() const {
+  constexpr iterator begin() const {
     return left_;
   }
 
-  iterator end() const {
+  constexpr iterator end() const {
     return right_;
   }
 
-  view operator&=(const const_view& other) const
+  constexpr view operator&=(const const_view& other) const
+    requires (!std::is_const_v<T>)
+  {
+    return iteration_with_bits_operation(std::bit_and<word_type>{}, kernels::bit_and, other);
+  }
+
+  constexpr view operator|=(const const_view& other) const
+    requires (!std::is_const_v<T>)
+  {
+    return iteration_with_bits_operation(std::bit_or<word_type>{}, kernels::bit_or, other);
+  }
+
+  constexpr view operator^=(const const_view& other) const
+    requires (!std::is_const_v<T>)
+  {
+    return iteration_with_bits_operation(std::bit_xor<word_type>{}, kernels::bit_xor, other);
+  }
+
+  // Expressions are evaluated first, so they may read the bits of this view.
+  template <typename Expression>
+  view operator&=(const bitset_expression<Expression>& expr) const
     requires (!std::is_const_v<T>)
   {
-    return iteration_with_bits_operation(std::bit_and<word_type>{}, other);
+    return *this &= const_view(expr);
   }
 
-  view operator|=(const const_view& other) const
+  template <typename Expression>
+  view operator|=(const bitset_expression<Expression>& expr) const
     requires (!std::is_const_v<T>)
   {
-    return iteration_with_bits_operation(std::bit_or<word_type>{}, other);
+    return *this |= const_view(expr);
   }
 
-  view operator^=(const const_view& other) const
+  template <typename Expression>
+  view operator^=(const bitset_expression<Expression>& expr) const
     requires (!std::is_const_v<T>)
   {
-    return iteration_with_bits_operation(std::bit_xor<word_type>{}, other);
+    return *this ^= const_view(expr);
+  }
+
+  constexpr view flip() const
+    requires (!std::is_const_v<T>)
+  {
+    return iteration_with_operation(
+        [](word_type value, std::size_t count) {
+          return value ^ (constants::max >> (constants::word_size_bits - count));
+        },
+        kernels::bit_not
+    );
   }
 
-  view flip() const
+  constexpr view set() const
     requires (!std::is_const_v<T>)
   {
-    return iteration_with_operation([](word_type value, std::size_t count) {
-      return value ^ (constants::max >> (constants::word_size_bits - count));
-    });
+    return iteration_with_operation(
+        []([[maybe_unused]] word_type value, std::size_t count) {
+          return (constants::max >> (constants::word_size_bits - count));
+        },
+        [](word_type* first, std::size_t words) { std::fill_n(first, words, constants::max); }
+    );
   }
 
-  view set() const
+  constexpr view reset() const
     requires (!std::is_const_v<T>)
   {
-    return iteration_with_operation([]([[maybe_unused]] word_type value, std::size_t count) {
-      return (constants::max >> (constants::word_size_bits - count));
-    });
+    return iteration_with_operation(
+        []([[maybe_unused]] word_type value, [[maybe_unused]] std::size_t count) { return static_cast<word_type>(0); },
+        [](word_type* first, std::size_t words) { std::fill_n(first, words, static_cast<word_type>(0)); }
+    );
   }
 
-  view reset() const
+  // Shifts bits towards the beginning of the view, filling the vacated end with zeros.
+  constexpr view operator<<=(std::size_t count) const
     requires (!std::is_const_v<T>)
   {
-    return iteration_with_operation([]([[maybe_unused]] word_type value, [[maybe_unused]] std::size_t count) {
-      return static_cast<word_type>(0);
-    });
+    if (count >= size()) {
+      return reset();
+    }
+    move_bits(0, count, size() - count);
+    view(begin() + static_cast<ptrdiff_t>(size() - count), end()).reset();
+    return view(*this);
   }
 
-  bool all() const {
+  // Shifts bits towards the end of the view, filling the vacated beginning with zeros.
+  constexpr view operator>>=(std::size_t count) const
+    requires (!std::is_const_v<T>)
+  {
+    if (count >= size()) {
+      return reset();
+    }
+    move_bits(count, 0, size() - count);
+    view(begin(), begin() + static_cast<ptrdiff_t>(count)).reset();
+    return view(*this);
+  }
+
+  constexpr bool all() const {
     return iteration_for_bool(
         [](word_type value, std::size_t count) {
           return !(value == (constants::max >> (constants::word_size_bits - count)));
         },
+        [](const word_type* first, std::size_t words) { return !kernels::all(first, words); },
         false
     );
   }
 
-  bool any() const {
-    return iteration_for_bool([](word_type value, [[maybe_unused]] std::size_t count) { return value; }, true);
+  constexpr bool any() const {
+    return iteration_for_bool(
+        [](word_type value, [[maybe_unused]] std::size_t count) { return value; },
+        kernels::any,
+        true
+    );
   }
 
-  std::size_t count() const {
+  constexpr std::size_t count() const {
     std::size_t ans = 0;
-    iterator it = begin();
-    while (it < end()) {
-      std::size_t count = std::min(constants::word_size_bits, static_cast<std::size_t>(end() - it));
-      word_type value = it.get(count);
-      ans += std::popcount(value);
-      it += static_cast<ptrdiff_t>(count);
-    }
+    for_each_chunk(
+        [&](std::size_t pos, std::size_t count) {
+          ans += std::popcount(get_word(pos, count));
+          return false;
+        },
+        [&](std::size_t pos, std::size_t words) {
+          ans += kernels::popcount((begin() + static_cast<ptrdiff_t>(pos)).word(), words);
+          return false;
+        }
+    );
     return ans;
   }
 
-  view subview(std::size_t offset = 0, std::size_t count = constants::npos) {
+  constexpr std::size_t find_first() const {
+    return find_from(0);
+  }
+
+  constexpr std::size_t find_next(std::size_t pos) const {
+    return pos >= size() ? constants::npos : find_from(pos + 1);
+  }
+
+  constexpr std::size_t find_last() const {
+    return find_before(size());
+  }
+
+  constexpr std::size_t find_prev(std::size_t pos) const {
+    return find_before(std::min(pos, size()));
+  }
+
+  // Copies up to `count` bits starting at `pos` to `dst` as if they started at a word boundary.
+  // The last written word is zero-padded. Returns the number of copied bits.
+  constexpr std::size_t copy_words(std::remove_const_t<word_type>* dst, std::size_t pos, std::size_t count) const {
+    pos = std::min(pos, size());
+    count = std::min(count, size() - pos);
+    iterator first = begin() + static_cast<ptrdiff_t>(pos);
+    std::size_t words = (count + constants::word_size_bits - 1) / constants::word_size_bits;
+    if (first.offset() == 0) {
+      std::copy(first.word(), first.word() + words, dst);
+      if (count % constants::word_size_bits != 0) {
+        dst[words - 1] &= constants::max >> (constants::word_size_bits - count % constants::word_size_bits);
+      }
+    } else {
+      for (std::size_t ind = 0; ind < count; ind += constants::word_size_bits) {
+        dst[ind / constants::word_size_bits] = get_word(pos + ind, std::min(constants::word_size_bits, count - ind));
+      }
+    }
+    return count;
+  }
+
+  constexpr bitset_set_bits<const word_type> set_bits() const {
+    return bitset_set_bits<const word_type>(*this);
+  }
+
+  constexpr view subview(std::size_t offset = 0, std::size_t count = constants::npos) {
     if (offset > size()) {
       return {end(), end()};
     } else if (count <= size() - offset) {
@@ -140,7 +254,7 @@ public:
     }
   }
 
-  const_view subview(std::size_t offset = 0, std::size_t count = constants::npos) const {
+  constexpr const_view subview(std::size_t offset = 0, std::size_t count = constants::npos) const {
     if (offset > size()) {
       return {end(), end()};
     } else if (count <= size() - offset) {
@@ -153,54 +267,109 @@ public:
     }
   }
 
-  friend bool operator==(const view& left, const view& right) {
-    if (left.size() == right.size()) {
-      std::size_t ind = 0;
-      while (ind < left.size()) {
-        std::size_t count = std::min(constants::word_size_bits, left.size() - ind);
-        if (left.get_word(ind, count) != right.get_word(ind, count)) {
-          return false;
-        }
-        ind += count;
-      }
-      return true;
-    }
-    return false;
+  friend constexpr bool operator==(const view& left, const view& right) {
+    return left.equals(right);
   }
 
-  friend bool operator!=(const view& left, const view& right) {
+  friend constexpr bool operator!=(const view& left, const view& right) {
     return !(left == right);
   }
 
-  ~bitset_view() = default;
+  constexpr ~bitset_view() = default;
 
 private:
-  template <typename Func>
-  bool iteration_for_bool(const Func func, bool cond_result) const {
-    iterator it = begin();
-    while (it < end()) {
-      std::size_t count = std::min(constants::word_size_bits, static_cast<std::size_t>(end() - it));
-      if (func(it.get(count), count)) {
-        return cond_result;
-      }
-      it += static_cast<ptrdiff_t>(count);
+  // Splits the view into a partial head up to the first word boundary, a run of whole words
+  // and a partial tail, so that the middle part can be processed without shifts and masks.
+  // Both callbacks return true to stop the iteration early.
+  template <typename ChunkFunc, typename WordsFunc>
+  constexpr bool for_each_chunk(const ChunkFunc chunk_func, const WordsFunc words_func) const {
+    std::size_t pos = std::min(size(), (constants::word_size_bits - begin().offset()) % constants::word_size_bits);
+    if (pos != 0 && chunk_func(static_cast<std::size_t>(0), pos)) {
+      return true;
     }
-    return !cond_result;
+    std::size_t words = (size() - pos) / constants::word_size_bits;
+    if (words != 0 && words_func(pos, words)) {
+      return true;
+    }
+    pos += words * constants::word_size_bits;
+    return pos < size() && chunk_func(pos, size() - pos);
   }
 
-  template <typename Func>
-  view iteration_with_operation(const Func func) const {
-    iterator it = begin();
-    while (it < end()) {
-      std::size_t count = std::min(constants::word_size_bits, static_cast<std::size_t>(end() - it));
-      it.set(func(it.get(count), count), count);
-      it += static_cast<ptrdiff_t>(count);
+  constexpr bool equals(const view& other) const {
+    if (size() != other.size()) {
+      return false;
+    }
+    if (begin().offset() == other.begin().offset()) {
+      return !for_each_chunk(
+          [&](std::size_t pos, std::size_t count) { return get_word(pos, count) != other.get_word(pos, count); },
+          [&](std::size_t pos, std::size_t words) {
+            return !kernels::equal(
+                (begin() + static_cast<ptrdiff_t>(pos)).word(),
+                (other.begin() + static_cast<ptrdiff_t>(pos)).word(),
+                words
+            );
+          }
+      );
+    }
+    std::size_t ind = 0;
+    while (ind < size()) {
+      std::size_t count = std::min(constants::word_size_bits, size() - ind);
+      if (get_word(ind, count) != other.get_word(ind, count)) {
+        return false;
+      }
+      ind += count;
     }
+    return true;
+  }
+
+  template <typename Func, typename WordsFunc>
+  constexpr bool iteration_for_bool(const Func func, const WordsFunc words_func, bool cond_result) const {
+    bool found = for_each_chunk(
+        [&](std::size_t pos, std::size_t count) { return static_cast<bool>(func(get_word(pos, count), count)); },
+        [&](std::size_t pos, std::size_t words) {
+          return words_func((begin() + static_cast<ptrdiff_t>(pos)).word(), words);
+        }
+    );
+    return found ? cond_result : !cond_result;
+  }
+
+  template <typename Func, typename WordsFunc>
+  constexpr view iteration_with_operation(const Func func, const WordsFunc words_func) const {
+    for_each_chunk(
+        [&](std::size_t pos, std::size_t count) {
+          iterator it = begin() + static_cast<ptrdiff_t>(pos);
+          it.set(func(it.get(count), count), count);
+          return false;
+        },
+        [&](std::size_t pos, std::size_t words) {
+          words_func((begin() + static_cast<ptrdiff_t>(pos)).word(), words);
+          return false;
+        }
+    );
     return view(*this);
   }
 
-  template <typename Func>
-  view iteration_with_bits_operation(const Func bit_function, const const_view& other) const {
+  template <typename Func, typename WordsFunc>
+  constexpr view
+  iteration_with_bits_operation(const Func bit_function, const WordsFunc words_func, const const_view& other) const {
+    if (begin().offset() == other.begin().offset()) {
+      for_each_chunk(
+          [&](std::size_t pos, std::size_t count) {
+            iterator it = begin() + static_cast<ptrdiff_t>(pos);
+            it.set(bit_function(it.get(count), other.get_word(pos, count)), count);
+            return false;
+          },
+          [&](std::size_t pos, std::size_t words) {
+            words_func(
+                (begin() + static_cast<ptrdiff_t>(pos)).word(),
+                (other.begin() + static_cast<ptrdiff_t>(pos)).word(),
+                words
+            );
+            return false;
+          }
+      );
+      return view(*this);
+    }
     iterator it = begin();
     while (it < end()) {
       std::size_t count = std::min(constants::word_size_bits, static_cast<std::size_t>(end() - it));
@@ -211,9 +380,57 @@ private:
     return view(*this);
   }
 
-  word_type get_word(std::size_t pos, std::size_t count) const {
+  // Moves `count` bits from `from` to `to` one word at a time, choosing the direction
+  // so that overlapping source bits are read before they are overwritten.
+  constexpr void move_bits(std::size_t to, std::size_t from, std::size_t count) const {
+    if (to < from) {
+      for (std::size_t ind = 0; ind < count;) {
+        std::size_t len = std::min(constants::word_size_bits, count - ind);
+        (begin() + static_cast<ptrdiff_t>(to + ind)).set(get_word(from + ind, len), len);
+        ind += len;
+      }
+    } else {
+      for (std::size_t ind = count; ind > 0;) {
+        std::size_t len = std::min(constants::word_size_bits, ind);
+        ind -= len;
+        (begin() + static_cast<ptrdiff_t>(to + ind)).set(get_word(from + ind, len), len);
+      }
+    }
+  }
+
+  constexpr std::size_t find_from(std::size_t pos) const {
+    while (pos < size()) {
+      std::size_t count = std::min(constants::word_size_bits, size() - pos);
+      word_type value = get_word(pos, count);
+      if (value != 0) {
+        return pos + static_cast<std::size_t>(std::countr_zero(value));
+      }
+      pos += count;
+    }
+    return constants::npos;
+  }
+
+  constexpr std::size_t find_before(std::size_t pos) const {
+    while (pos > 0) {
+      std::size_t count = std::min(constants::word_size_bits, pos);
+      pos -= count;
+      word_type value = get_word(pos, count);
+      if (value != 0) {
+        return pos + static_cast<std::size_t>(std::bit_width(value)) - 1;
+      }
+    }
+    return constants::npos;
+  }
+
+  constexpr word_type get_word(std::size_t pos, std::size_t count) const {
     return (begin() + static_cast<ptrdiff_t>(pos)).get(count);
   }
 
   iterator left_, right_;
+
+  template <typename T1>
+  friend class bitset_view;
+  template <typename T2>
+  friend class bitset_set_bits;
+  friend class bitset_rank_select;
 };
@@ -1,26 +1,40 @@
 #include "bitset.h"
 
+#include "bitset-kernels.h"
+
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <cstddef>
+#include <istream>
+#include <limits>
+#include <memory_resource>
 #include <ostream>
 #include <string>
+#include <utility>
 
 bitset::bitset()
-    : data_(nullptr)
-    , size_(0) {}
-
-bitset::bitset(std::size_t size)
-    : size_(size) {
-  if (size_ > 0) {
-    data_ = new word_type[(size_ + constants::word_size_bits - 1) / constants::word_size_bits]();
+    : bitset(allocator_type()) {}
+
+bitset::bitset(const allocator_type& alloc)
+    : bitset(0, alloc) {}
+
+bitset::bitset(std::size_t size, const allocator_type& alloc)
+    : size_(size)
+    , resource_(alloc.resource()) {
+  std::size_t words = (size_ + constants::word_size_bits - 1) / constants::word_size_bits;
+  if (words > constants::small_words) {
+    data_ = get_allocator().allocate(words);
+    std::fill_n(data_, words, static_cast<word_type>(0));
+    capacity_ = words;
   } else {
-    data_ = nullptr;
+    data_ = small_.data();
+    capacity_ = constants::small_words;
   }
 }
 
-bitset::bitset(std::size_t size, bool value)
-    : bitset(size) {
+bitset::bitset(std::size_t size, bool value, const allocator_type& alloc)
+    : bitset(size, alloc) {
   if (value) {
     std::fill_n(data_, size_ / constants::word_size_bits, constants::max);
     if (size_ % constants::word_size_bits != 0) {
@@ -33,27 +47,37 @@ bitset::bitset(std::size_t size, bool value)
 }
 
 bitset::bitset(const bitset& other)
-    : bitset(other.size_) {
+    : bitset(other, allocator_type()) {}
+
+bitset::bitset(const bitset& other, const allocator_type& alloc)
+    : bitset(other.size_, alloc) {
   std::size_t count = (size_ + constants::word_size_bits - 1) / constants::word_size_bits;
   std::copy(other.data_, other.data_ + count, data_);
 }
 
-bitset::bitset(std::string_view str)
-    : bitset(str.size()) {
-  std::size_t count = 0;
-  for (auto c : str) {
-    if (c == '1') {
-      data_[count / constants::word_size_bits] ^= (constants::one) << (count % constants::word_size_bits);
-    }
-    count++;
-  }
+bitset::bitset(bitset&& other) noexcept
+    : bitset(other.get_allocator()) {
+  swap(other);
+}
+
+bitset::bitset(std::string_view str, const allocator_type& alloc)
+    : bitset(str.size(), alloc) {
+  kernels::parse(data_, str.data(), size_);
 }
 
-bitset::bitset(const const_view& other)
-    : bitset(other.begin(), other.end()) {}
+bitset::bitset(const const_view& other, const allocator_type& alloc)
+    : bitset(other.begin(), other.end(), alloc) {}
 
-bitset::bitset(const_iterator first, const_iterator last)
-    : bitset(static_cast<std::size_t>(last - first)) {
+bitset::bitset(const_iterator first, const_iterator last, const allocator_type& alloc)
+    : bitset(static_cast<std::size_t>(last - first), alloc) {
+  if (first.offset() == 0) {
+    std::size_t count = (size_ + constants::word_size_bits - 1) / constants::word_size_bits;
+    std::copy(first.word(), first.word() + count, data_);
+    if (size_ % constants::word_size_bits != 0) {
+      data_[count - 1] &= (constants::max >> (constants::word_size_bits - size_ % constants::word_size_bits));
+    }
+    return;
+  }
   const_iterator it = first;
   while (it < last) {
     std::size_t count = std::min(constants::word_size_bits, static_cast<std::size_t>(last - it));
@@ -64,30 +88,68 @@ bitset::bitset(const_iterator first, const_iterator last)
 
 bitset& bitset::operator=(const bitset& other) & {
   if (&other != this) {
-    bitset(other).swap(*this);
+    bitset(other, get_allocator()).swap(*this);
+  }
+  return *this;
+}
+
+bitset& bitset::operator=(bitset&& other) & {
+  if (&other == this) {
+    return *this;
+  }
+  if (*resource_ == *other.resource_) {
+    bitset copy(std::move(other));
+    swap(copy);
+  } else {
+    *this = other;
   }
   return *this;
 }
 
 bitset& bitset::operator=(std::string_view str) & {
-  bitset copy = bitset(str);
+  bitset copy = bitset(str, get_allocator());
   swap(copy);
   return *this;
 }
 
 bitset& bitset::operator=(const const_view& other) & {
-  bitset copy = bitset(other);
+  bitset copy = bitset(other, get_allocator());
   swap(copy);
   return *this;
 }
 
 bitset::~bitset() {
-  delete[] data_;
+  if (!is_small()) {
+    get_allocator().deallocate(data_, capacity_);
+  }
 }
 
 void bitset::swap(bitset& other) {
+  bool small = is_small();
+  bool other_small = other.is_small();
   std::swap(data_, other.data_);
   std::swap(size_, other.size_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(resource_, other.resource_);
+  std::swap(small_, other.small_);
+  if (other_small) {
+    data_ = small_.data();
+  }
+  if (small) {
+    other.data_ = other.small_.data();
+  }
+}
+
+bitset::allocator_type bitset::get_allocator() const {
+  return resource_;
+}
+
+const bitset::word_type* bitset::data() const {
+  return data_;
+}
+
+bitset::word_type* bitset::data() {
+  return data_;
 }
 
 std::size_t bitset::size() const {
@@ -98,6 +160,67 @@ bool bitset::empty() const {
   return size() == 0;
 }
 
+std::size_t bitset::capacity() const {
+  return capacity_ * constants::word_size_bits;
+}
+
+void bitset::reserve(std::size_t capacity) {
+  if (capacity > this->capacity()) {
+    with_capacity((capacity + constants::word_size_bits - 1) / constants::word_size_bits).swap(*this);
+  }
+}
+
+void bitset::shrink_to_fit() {
+  std::size_t words = (size_ + constants::word_size_bits - 1) / constants::word_size_bits;
+  if (!is_small() && capacity_ > words) {
+    with_capacity(words).swap(*this);
+  }
+}
+
+void bitset::resize(std::size_t size, bool value) {
+  if (size <= size_) {
+    std::size_t old_words = (size_ + constants::word_size_bits - 1) / constants::word_size_bits;
+    size_ = size;
+    std::size_t words = (size_ + constants::word_size_bits - 1) / constants::word_size_bits;
+    std::fill(data_ + words, data_ + old_words, static_cast<word_type>(0));
+    if (size_ % constants::word_size_bits != 0) {
+      data_[words - 1] &= (constants::max >> (constants::word_size_bits - size_ % constants::word_size_bits));
+    }
+    return;
+  }
+  if (size > capacity()) {
+    with_capacity(grown_capacity(size)).swap(*this);
+  }
+  std::size_t old_size = size_;
+  size_ = size;
+  if (value) {
+    subview(old_size).set();
+  }
+}
+
+void bitset::push_back(bool value) {
+  if (size_ == capacity()) {
+    with_capacity(grown_capacity(size_ + 1)).swap(*this);
+  }
+  data_[size_ / constants::word_size_bits] |= static_cast<word_type>(value) << (size_ % constants::word_size_bits);
+  ++size_;
+}
+
+bitset& bitset::append(const const_view& other) & {
+  std::size_t old_size = size_;
+  if (size_ + other.size() > capacity()) {
+    // `other` may refer to the words of this bitset, so they are released after copying.
+    bitset copy = with_capacity(grown_capacity(size_ + other.size()));
+    copy.size_ += other.size();
+    copy.subview(old_size) |= other;
+    swap(copy);
+  } else {
+    size_ += other.size();
+    subview(old_size) |= other;
+  }
+  return *this;
+}
+
 bitset::reference bitset::operator[](std::size_t index) {
   return {data_[index / constants::word_size_bits], index % constants::word_size_bits};
 }
@@ -140,33 +263,13 @@ bitset& bitset::operator^=(const const_view& other) & {
   return *this;
 }
 
-bitset& bitset::iteration_for_shifts(std::size_t count, std::size_t size) {
-  bitset copy = bitset(count, false);
-  std::size_t ind = 0;
-  while (ind < size) {
-    if (ind + constants::word_size_bits <= size) {
-      copy.data_[ind / constants::word_size_bits] = data_[ind / constants::word_size_bits];
-      ind += constants::word_size_bits;
-    } else {
-      copy.data_[ind / constants::word_size_bits] ^=
-          (data_[ind / constants::word_size_bits] & (constants::one << (ind % constants::word_size_bits)));
-      ind++;
-    }
-  }
-  swap(copy);
-  return *this;
-}
-
 bitset& bitset::operator<<=(std::size_t count) & {
-  return iteration_for_shifts(size() + count, size());
+  resize(size_ + count);
+  return *this;
 }
 
 bitset& bitset::operator>>=(std::size_t count) & {
-  if (size() >= count) {
-    return iteration_for_shifts(size() - count, size() - count);
-  }
-  bitset copy = bitset();
-  swap(copy);
+  resize(size_ - std::min(count, size_));
   return *this;
 }
 
@@ -197,11 +300,27 @@ bool bitset::any() const {
 }
 
 std::size_t bitset::count() const {
-  std::size_t ans = 0;
-  for (std::size_t ind = 0; ind < size(); ind += constants::word_size_bits) {
-    ans += std::popcount(data_[ind / constants::word_size_bits]);
-  }
-  return ans;
+  return kernels::popcount(data_, (size_ + constants::word_size_bits - 1) / constants::word_size_bits);
+}
+
+std::size_t bitset::find_first() const {
+  return subview().find_first();
+}
+
+std::size_t bitset::find_next(std::size_t pos) const {
+  return subview().find_next(pos);
+}
+
+std::size_t bitset::find_last() const {
+  return subview().find_last();
+}
+
+std::size_t bitset::find_prev(std::size_t pos) const {
+  return subview().find_prev(pos);
+}
+
+bitset_set_bits<const bitset::word_type> bitset::set_bits() const {
+  return subview().set_bits();
 }
 
 bitset::operator const_view() const {
@@ -238,58 +357,129 @@ bitset::const_view bitset::subview(std::size_t offset, std::size_t count) const
   }
 }
 
-bitset operator&(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset ans = bitset(lhs);
-  ans &= rhs;
-  return ans;
+bool bitset::is_small() const {
+  return data_ == small_.data();
 }
 
-bitset operator|(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset ans = bitset(lhs);
-  ans |= rhs;
+bitset bitset::with_capacity(std::size_t words) const {
+  bitset ans(get_allocator());
+  if (words > constants::small_words) {
+    ans.data_ = ans.get_allocator().allocate(words);
+    std::fill_n(ans.data_, words, static_cast<word_type>(0));
+    ans.capacity_ = words;
+  }
+  std::size_t count = (size_ + constants::word_size_bits - 1) / constants::word_size_bits;
+  std::copy(data_, data_ + count, ans.data_);
+  ans.size_ = size_;
   return ans;
 }
 
-bitset operator^(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset ans = bitset(lhs);
-  ans ^= rhs;
-  return ans;
+std::size_t bitset::grown_capacity(std::size_t size) const {
+  return std::max((size + constants::word_size_bits - 1) / constants::word_size_bits, 2 * capacity_);
 }
 
-bitset operator~(const bitset::const_view& vw) {
-  bitset ans = bitset(vw);
-  ans.flip();
-  return ans;
+namespace {
+// Number of words converted at once when a view is formatted or serialized.
+constexpr std::size_t chunk_words = 512;
+
+void write_word(std::ostream& out, bitset::word_type value) {
+  std::array<char, sizeof(value)> bytes{};
+  for (auto& byte : bytes) {
+    byte = static_cast<char>(value & std::numeric_limits<unsigned char>::max());
+    value >>= std::numeric_limits<unsigned char>::digits;
+  }
+  out.write(bytes.data(), bytes.size());
 }
 
-bitset operator<<(const bitset::const_view& vw, std::size_t count) {
-  bitset ans = bitset(vw);
-  ans <<= count;
-  return ans;
+bitset::word_type read_word(std::istream& in) {
+  std::array<char, sizeof(bitset::word_type)> bytes{};
+  in.read(bytes.data(), bytes.size());
+  bitset::word_type value = 0;
+  for (auto it = bytes.rbegin(); it != bytes.rend(); ++it) {
+    value <<= std::numeric_limits<unsigned char>::digits;
+    value |= static_cast<unsigned char>(*it);
+  }
+  return value;
 }
 
-bitset operator>>(const bitset::const_view& vw, std::size_t count) {
-  bitset ans = bitset(vw);
-  ans >>= count;
-  return ans;
+template <typename Func>
+void for_each_words_chunk(const bitset::const_view& vw, Func func) {
+  std::array<bitset::word_type, chunk_words> words{};
+  for (std::size_t pos = 0; pos < vw.size(); pos += chunk_words * constants::word_size_bits) {
+    func(words.data(), vw.copy_words(words.data(), pos, chunk_words * constants::word_size_bits));
+  }
 }
+} // namespace
 
 std::string to_string(const bitset::const_view& vw) {
-  std::string ans;
-  ans.reserve(vw.size());
-  for (auto el : vw) {
-    ans += el ? '1' : '0';
-  }
+  std::string ans(vw.size(), '0');
+  std::size_t pos = 0;
+  for_each_words_chunk(vw, [&](const bitset::word_type* words, std::size_t count) {
+    kernels::format(ans.data() + pos, words, count);
+    pos += count;
+  });
   return ans;
 }
 
 std::ostream& operator<<(std::ostream& out, const bitset::const_view& vw) {
-  for (auto el : vw) {
-    out << (el ? "1" : "0");
-  }
+  std::string buffer(std::min(vw.size(), chunk_words * constants::word_size_bits), '0');
+  for_each_words_chunk(vw, [&](const bitset::word_type* words, std::size_t count) {
+    kernels::format(buffer.data(), words, count);
+    out.write(buffer.data(), static_cast<std::streamsize>(count));
+  });
+  return out;
+}
+
+std::ostream& write_binary(std::ostream& out, const bitset::const_view& vw) {
+  write_word(out, vw.size());
+  for_each_words_chunk(vw, [&](const bitset::word_type* words, std::size_t count) {
+    std::size_t words_count = (count + constants::word_size_bits - 1) / constants::word_size_bits;
+    if constexpr (std::endian::native == std::endian::little) {
+      out.write(reinterpret_cast<const char*>(words), static_cast<std::streamsize>(words_count * sizeof(*words)));
+    } else {
+      std::for_each(words, words + words_count, [&](bitset::word_type value) { write_word(out, value); });
+    }
+  });
   return out;
 }
 
+// The words are read in chunks and the bitset grows with them, so a header claiming more bits
+// than the stream holds fails on the missing words without allocating for all of them.
+std::istream& read_binary(std::istream& in, bitset& bs) {
+  bitset::word_type header = read_word(in);
+  if (!in) {
+    return in;
+  }
+  if (!std::in_range<std::size_t>(header)) {
+    in.setstate(std::ios_base::failbit);
+    return in;
+  }
+  auto size = static_cast<std::size_t>(header);
+  std::size_t tail = size % constants::word_size_bits;
+  std::size_t words = size / constants::word_size_bits + (tail != 0);
+  bitset ans(bs.get_allocator());
+  for (std::size_t pos = 0; pos < words;) {
+    std::size_t count = std::min(chunk_words, words - pos);
+    ans.resize(pos + count == words ? size : (pos + count) * constants::word_size_bits);
+    if constexpr (std::endian::native == std::endian::little) {
+      auto bytes = static_cast<std::streamsize>(count * sizeof(bitset::word_type));
+      in.read(reinterpret_cast<char*>(ans.data() + pos), bytes);
+    } else {
+      std::generate_n(ans.data() + pos, count, [&] { return read_word(in); });
+    }
+    if (!in) {
+      return in;
+    }
+    pos += count;
+  }
+  if (tail != 0 && (ans.data()[words - 1] >> tail) != 0) {
+    in.setstate(std::ios_base::failbit);
+    return in;
+  }
+  bs.swap(ans);
+  return in;
+}
+
 void swap(bitset& lhs, bitset& rhs) {
   lhs.swap(rhs);
 }
@@ -1,11 +1,19 @@
 #pragma once
 
 #include "bitset-constants.h"
+#include "bitset-expression.h"
 #include "bitset-iterator.h"
+#include "bitset-set-bits.h"
 #include "bitset-view.h"
 
+#include <array>
 #include <cstddef>
+#include <functional>
+#include <iosfwd>
 #include <limits>
+#include <memory>
+#include <memory_resource>
+#include <string>
 #include <string_view>
 
 class bitset {
@@ -19,26 +27,62 @@ public:
   using view = bitset_view<word_type>;
   using const_view = bitset_view<const word_type>;
 
+  using allocator_type = std::pmr::polymorphic_allocator<word_type>;
+
   static constexpr std::size_t npos = -1;
 
   bitset();
-  bitset(std::size_t size, bool value);
+  explicit bitset(const allocator_type& alloc);
+  bitset(std::size_t size, bool value, const allocator_type& alloc = {});
   bitset(const bitset& other);
-  explicit bitset(std::string_view str);
-  explicit bitset(const const_view& other);
-  bitset(const_iterator first, const_iterator last);
+  bitset(const bitset& other, const allocator_type& alloc);
+  bitset(bitset&& other) noexcept;
+  explicit bitset(std::string_view str, const allocator_type& alloc = {});
+  explicit bitset(const const_view& other, const allocator_type& alloc = {});
+  bitset(const_iterator first, const_iterator last, const allocator_type& alloc = {});
+
+  // Evaluates an expression of the free bitwise operators in a single pass.
+  template <typename Expression>
+  bitset(const bitset_expression<Expression>& expr, const allocator_type& alloc = {})
+      : bitset(static_cast<const Expression&>(expr).size(), alloc) {
+    expr.evaluate(data_);
+  }
 
   bitset& operator=(const bitset& other) &;
+  // Takes the words of `other` if both use equal memory resources, otherwise copies them.
+  bitset& operator=(bitset&& other) &;
   bitset& operator=(std::string_view str) &;
   bitset& operator=(const const_view& other) &;
 
+  template <typename Expression>
+  bitset& operator=(const bitset_expression<Expression>& expr) & {
+    bitset(expr, get_allocator()).swap(*this);
+    return *this;
+  }
+
   ~bitset();
 
   void swap(bitset& other);
 
+  allocator_type get_allocator() const;
+
+  // Bit i is stored in bit (i % 64) of word i / 64, bits past size() are zero.
+  const word_type* data() const;
+  word_type* data();
+
   std::size_t size() const;
   bool empty() const;
 
+  // Number of bits that fit into the allocated words.
+  std::size_t capacity() const;
+  void reserve(std::size_t capacity);
+  void shrink_to_fit();
+
+  // Growing operations reallocate geometrically, so appending bits one by one takes amortized O(1).
+  void resize(std::size_t size, bool value = false);
+  void push_back(bool value);
+  bitset& append(const const_view& other) &;
+
   reference operator[](std::size_t index);
   const_reference operator[](std::size_t index) const;
 
@@ -51,6 +95,27 @@ public:
   bitset& operator&=(const const_view& other) &;
   bitset& operator|=(const const_view& other) &;
   bitset& operator^=(const const_view& other) &;
+
+  // Combine the expression into the words in place, a chunk at a time. The expression may read
+  // this bitset, but not its subviews starting past the first bit.
+  template <typename Expression>
+  bitset& operator&=(const bitset_expression<Expression>& expr) & {
+    expr.template apply_words<std::bit_and<>>(data_, 0, expr.words());
+    return *this;
+  }
+
+  template <typename Expression>
+  bitset& operator|=(const bitset_expression<Expression>& expr) & {
+    expr.template apply_words<std::bit_or<>>(data_, 0, expr.words());
+    return *this;
+  }
+
+  template <typename Expression>
+  bitset& operator^=(const bitset_expression<Expression>& expr) & {
+    expr.template apply_words<std::bit_xor<>>(data_, 0, expr.words());
+    return *this;
+  }
+
   bitset& operator<<=(std::size_t count) &;
   bitset& operator>>=(std::size_t count) &;
   bitset& flip() &;
@@ -62,6 +127,12 @@ public:
   bool any() const;
   std::size_t count() const;
 
+  std::size_t find_first() const;
+  std::size_t find_next(std::size_t pos) const;
+  std::size_t find_last() const;
+  std::size_t find_prev(std::size_t pos) const;
+  bitset_set_bits<const word_type> set_bits() const;
+
   operator const_view() const;
   operator view();
 
@@ -69,24 +140,64 @@ public:
   const_view subview(std::size_t offset = 0, std::size_t count = npos) const;
 
 private:
-  bitset& iteration_for_shifts(std::size_t count, std::size_t size);
-  bitset(std::size_t size);
+  bitset(std::size_t size, const allocator_type& alloc);
+
+  bool is_small() const;
+  // Copy of this bitset with `words` words allocated, at least enough for size().
+  bitset with_capacity(std::size_t words) const;
+  // Number of words to allocate for `size` bits when growing.
+  std::size_t grown_capacity(std::size_t size) const;
 
   word_type* data_;
   std::size_t size_;
+  std::size_t capacity_;
+  std::pmr::memory_resource* resource_;
+  std::array<word_type, constants::small_words> small_{};
 };
 
-bitset operator&(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator|(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator^(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator<<(const bitset::const_view& vw, std::size_t count);
-bitset operator>>(const bitset::const_view& vw, std::size_t count);
-bitset operator~(const bitset::const_view& vw);
-
 std::string to_string(const bitset::const_view& vw);
 std::ostream& operator<<(std::ostream& out, const bitset::const_view& vw);
 
-bool operator==(const bitset::const_view& left, const bitset::const_view& right);
-bool operator!=(const bitset::const_view& left, const bitset::const_view& right);
+template <typename Derived>
+bitset_expression<Derived>::operator bitset_view<const word_type>() const {
+  if (!materialized_) {
+    materialized_ = std::make_shared<const bitset>(*this);
+  }
+  return *materialized_;
+}
+
+template <typename Derived>
+bitset_view<const constants::word_type> bitset_expression<Derived>::subview(std::size_t offset, std::size_t count)
+    const {
+  return bitset_view<const word_type>(*this).subview(offset, count);
+}
+
+template <typename Derived>
+bitset_iterator<const constants::word_type> bitset_expression<Derived>::begin() const {
+  return bitset_view<const word_type>(*this).begin();
+}
+
+template <typename Derived>
+bitset_iterator<const constants::word_type> bitset_expression<Derived>::end() const {
+  return bitset_view<const word_type>(*this).end();
+}
+
+template <typename Expression>
+std::string to_string(const bitset_expression<Expression>& expr) {
+  return to_string(bitset(expr));
+}
+
+template <typename Expression>
+std::ostream& operator<<(std::ostream& out, const bitset_expression<Expression>& expr) {
+  return out << bitset(expr);
+}
+
+// Binary format: the number of bits followed by the words, all as 64-bit little-endian integers.
+// On malformed input read_binary() sets failbit and leaves `bs` unchanged.
+std::ostream& write_binary(std::ostream& out, const bitset::const_view& vw);
+std::istream& read_binary(std::istream& in, bitset& bs);
+
+constexpr bool operator==(const bitset::const_view& left, const bitset::const_view& right);
+constexpr bool operator!=(const bitset::const_view& left, const bitset::const_view& right);
 
 void swap(bitset& lhs, bitset& rhs);
@@ -0,0 +1,429 @@
+#include "compressed-bitset.h"
+
+#include "bitset-kernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace {
+std::size_t words_count(std::size_t bits) {
+  return (bits + constants::word_size_bits - 1) / constants::word_size_bits;
+}
+
+bool test_word_bit(const constants::word_type* data, std::size_t pos) {
+  return (data[pos / constants::word_size_bits] >> (pos % constants::word_size_bits)) & 1;
+}
+
+template <typename Predicate>
+void erase_positions_if(std::vector<std::uint16_t>& positions, Predicate pred) {
+  positions.erase(std::remove_if(positions.begin(), positions.end(), pred), positions.end());
+}
+} // namespace
+
+compressed_bitset::container::kind compressed_bitset::container::best_kind(std::size_t count, std::size_t bits) {
+  if (count <= array_limit && count <= bits - count) {
+    return kind::ones;
+  } else if (bits - count <= array_limit) {
+    return kind::zeros;
+  }
+  return kind::bitmap;
+}
+
+compressed_bitset::container compressed_bitset::container::from_words(const word_type* data, std::size_t bits) {
+  container ans;
+  std::size_t words = words_count(bits);
+  std::size_t count = kernels::popcount(data, words);
+  ans.type = best_kind(count, bits);
+  if (ans.type == kind::bitmap) {
+    ans.words.assign(data, data + words);
+    ans.ones = count;
+    return ans;
+  }
+  bool inverted = ans.type == kind::zeros;
+  ans.positions.reserve(inverted ? bits - count : count);
+  for (std::size_t ind = 0; ind < words; ++ind) {
+    word_type value = inverted ? ~data[ind] : data[ind];
+    if (ind + 1 == words && bits % constants::word_size_bits != 0) {
+      value &= constants::max >> (constants::word_size_bits - bits % constants::word_size_bits);
+    }
+    for (; value != 0; value &= value - 1) {
+      auto pos = ind * constants::word_size_bits + static_cast<std::size_t>(std::countr_zero(value));
+      ans.positions.push_back(static_cast<std::uint16_t>(pos));
+    }
+  }
+  return ans;
+}
+
+void compressed_bitset::container::to_words(word_type* dst, std::size_t bits) const {
+  std::size_t words_size = words_count(bits);
+  switch (type) {
+  case kind::ones:
+    std::fill_n(dst, words_size, 0);
+    for (auto pos : positions) {
+      dst[pos / constants::word_size_bits] |= constants::one << (pos % constants::word_size_bits);
+    }
+    break;
+  case kind::zeros:
+    std::fill_n(dst, words_size, constants::max);
+    if (bits % constants::word_size_bits != 0) {
+      dst[words_size - 1] = constants::max >> (constants::word_size_bits - bits % constants::word_size_bits);
+    }
+    for (auto pos : positions) {
+      dst[pos / constants::word_size_bits] &= ~(constants::one << (pos % constants::word_size_bits));
+    }
+    break;
+  case kind::bitmap:
+    std::copy(words.begin(), words.end(), dst);
+    break;
+  }
+}
+
+bool compressed_bitset::container::test(std::size_t pos) const {
+  switch (type) {
+  case kind::ones:
+    return std::binary_search(positions.begin(), positions.end(), pos);
+  case kind::zeros:
+    return !std::binary_search(positions.begin(), positions.end(), pos);
+  case kind::bitmap:
+    return test_word_bit(words.data(), pos);
+  }
+  return false;
+}
+
+std::size_t compressed_bitset::container::count(std::size_t bits) const {
+  switch (type) {
+  case kind::ones:
+    return positions.size();
+  case kind::zeros:
+    return bits - positions.size();
+  case kind::bitmap:
+    return ones;
+  }
+  return 0;
+}
+
+compressed_bitset::compressed_bitset(std::size_t size, bool value)
+    : size_(size)
+    , chunks_((size + chunk_bits - 1) / chunk_bits) {
+  if (value) {
+    set();
+  }
+}
+
+compressed_bitset::compressed_bitset(const const_view& vw)
+    : size_(vw.size())
+    , chunks_((vw.size() + chunk_bits - 1) / chunk_bits) {
+  std::vector<word_type> buffer(chunk_words);
+  for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    std::size_t bits = vw.copy_words(buffer.data(), chunk * chunk_bits, chunk_bits);
+    chunks_[chunk] = container::from_words(buffer.data(), bits);
+  }
+}
+
+bitset compressed_bitset::to_bitset() const {
+  bitset ans(size_, false);
+  for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    chunks_[chunk].to_words(ans.data() + chunk * chunk_words, chunk_size(chunk));
+  }
+  return ans;
+}
+
+std::size_t compressed_bitset::size() const {
+  return size_;
+}
+
+bool compressed_bitset::empty() const {
+  return size_ == 0;
+}
+
+std::size_t compressed_bitset::memory_usage() const {
+  std::size_t ans = chunks_.capacity() * sizeof(container);
+  for (const auto& chunk : chunks_) {
+    ans += chunk.positions.capacity() * sizeof(std::uint16_t) + chunk.words.capacity() * sizeof(word_type);
+  }
+  return ans;
+}
+
+bool compressed_bitset::test(std::size_t pos) const {
+  return chunks_[pos / chunk_bits].test(pos % chunk_bits);
+}
+
+void compressed_bitset::set(std::size_t pos, bool value) {
+  container& chunk = chunks_[pos / chunk_bits];
+  std::size_t offset = pos % chunk_bits;
+  if (chunk.test(offset) == value) {
+    return;
+  }
+  if (chunk.type == container::kind::bitmap) {
+    chunk.words[offset / constants::word_size_bits] ^= constants::one << (offset % constants::word_size_bits);
+    chunk.ones = value ? chunk.ones + 1 : chunk.ones - 1;
+  } else {
+    auto it = std::lower_bound(chunk.positions.begin(), chunk.positions.end(), offset);
+    if (it != chunk.positions.end() && *it == offset) {
+      chunk.positions.erase(it);
+    } else {
+      chunk.positions.insert(it, static_cast<std::uint16_t>(offset));
+    }
+  }
+  normalize(pos / chunk_bits);
+}
+
+compressed_bitset& compressed_bitset::set() {
+  for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    chunks_[chunk] = {container::kind::zeros, {}, {}, 0};
+    normalize(chunk);
+  }
+  return *this;
+}
+
+compressed_bitset& compressed_bitset::reset() {
+  std::fill(chunks_.begin(), chunks_.end(), container());
+  return *this;
+}
+
+compressed_bitset& compressed_bitset::flip() {
+  for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    container& cur = chunks_[chunk];
+    switch (cur.type) {
+    case container::kind::ones:
+      cur.type = container::kind::zeros;
+      break;
+    case container::kind::zeros:
+      cur.type = container::kind::ones;
+      break;
+    case container::kind::bitmap: {
+      std::size_t bits = chunk_size(chunk);
+      kernels::bit_not(cur.words.data(), cur.words.size());
+      if (bits % constants::word_size_bits != 0) {
+        cur.words.back() &= constants::max >> (constants::word_size_bits - bits % constants::word_size_bits);
+      }
+      cur.ones = bits - cur.ones;
+      break;
+    }
+    }
+    normalize(chunk);
+  }
+  return *this;
+}
+
+bool compressed_bitset::all() const {
+  for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    if (chunks_[chunk].count(chunk_size(chunk)) != chunk_size(chunk)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool compressed_bitset::any() const {
+  for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    if (chunks_[chunk].count(chunk_size(chunk)) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::size_t compressed_bitset::count() const {
+  std::size_t ans = 0;
+  for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    ans += chunks_[chunk].count(chunk_size(chunk));
+  }
+  return ans;
+}
+
+compressed_bitset& compressed_bitset::operator&=(const compressed_bitset& other) {
+  return apply(operation::bit_and, other);
+}
+
+compressed_bitset& compressed_bitset::operator|=(const compressed_bitset& other) {
+  return apply(operation::bit_or, other);
+}
+
+compressed_bitset& compressed_bitset::operator^=(const compressed_bitset& other) {
+  return apply(operation::bit_xor, other);
+}
+
+compressed_bitset& compressed_bitset::operator&=(const const_view& other) {
+  return apply(operation::bit_and, other);
+}
+
+compressed_bitset& compressed_bitset::operator|=(const const_view& other) {
+  return apply(operation::bit_or, other);
+}
+
+compressed_bitset& compressed_bitset::operator^=(const const_view& other) {
+  return apply(operation::bit_xor, other);
+}
+
+void compressed_bitset::swap(compressed_bitset& other) {
+  std::swap(size_, other.size_);
+  chunks_.swap(other.chunks_);
+}
+
+std::size_t compressed_bitset::chunk_size(std::size_t chunk) const {
+  return std::min(chunk_bits, size_ - chunk * chunk_bits);
+}
+
+// Brings the chunk to the smallest representation, so that equal chunks are stored identically.
+void compressed_bitset::normalize(std::size_t chunk) {
+  container& cur = chunks_[chunk];
+  std::size_t bits = chunk_size(chunk);
+  if (cur.type != container::best_kind(cur.count(bits), bits)) {
+    std::vector<word_type> buffer(chunk_words);
+    cur.to_words(buffer.data(), bits);
+    cur = container::from_words(buffer.data(), bits);
+  }
+}
+
+compressed_bitset& compressed_bitset::apply(operation op, const compressed_bitset& other) {
+  std::vector<word_type> other_words;
+  std::vector<word_type> buffer;
+  for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    if (!apply_arrays(op, chunk, other.chunks_[chunk])) {
+      other_words.resize(chunk_words);
+      buffer.resize(chunk_words);
+      other.chunks_[chunk].to_words(other_words.data(), chunk_size(chunk));
+      apply_words(op, chunk, other_words.data(), buffer.data());
+    }
+  }
+  return *this;
+}
+
+// Intersections with a sparse chunk and unions with a dense chunk only probe the dense operand.
+compressed_bitset& compressed_bitset::apply(operation op, const const_view& other) {
+  std::vector<word_type> other_words(chunk_words);
+  std::vector<word_type> buffer(chunk_words);
+  for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    container& cur = chunks_[chunk];
+    if (op == operation::bit_and && cur.type == container::kind::ones) {
+      erase_positions_if(cur.positions, [&](std::size_t pos) { return !other[chunk * chunk_bits + pos]; });
+    } else if (op == operation::bit_or && cur.type == container::kind::zeros) {
+      erase_positions_if(cur.positions, [&](std::size_t pos) { return other[chunk * chunk_bits + pos]; });
+    } else {
+      other.copy_words(other_words.data(), chunk * chunk_bits, chunk_bits);
+      apply_words(op, chunk, other_words.data(), buffer.data());
+    }
+    normalize(chunk);
+  }
+  return *this;
+}
+
+// Combines two chunks without materializing them when at least one of them is an array.
+// Arrays of cleared positions are complements, so every combination reduces to a set operation.
+bool compressed_bitset::apply_arrays(operation op, std::size_t chunk, const container& other) {
+  using kind = container::kind;
+  container& cur = chunks_[chunk];
+  if (cur.type == kind::bitmap || other.type == kind::bitmap) {
+    const container& array = cur.type == kind::bitmap ? other : cur;
+    const container& bitmap = cur.type == kind::bitmap ? cur : other;
+    bool filter_ones = op == operation::bit_and && array.type == kind::ones;
+    bool filter_zeros = op == operation::bit_or && array.type == kind::zeros;
+    if (!filter_ones && !filter_zeros) {
+      return false;
+    }
+    container ans = {array.type, {}, {}, 0};
+    std::copy_if(
+        array.positions.begin(),
+        array.positions.end(),
+        std::back_inserter(ans.positions),
+        [&](std::size_t pos) { return bitmap.test(pos) == filter_ones; }
+    );
+    cur = std::move(ans);
+    normalize(chunk);
+    return true;
+  }
+
+  const auto& lhs = cur.positions;
+  const auto& rhs = other.positions;
+  bool lhs_ones = cur.type == kind::ones;
+  bool rhs_ones = other.type == kind::ones;
+  container ans;
+  auto out = std::back_inserter(ans.positions);
+  switch (op) {
+  case operation::bit_and:
+    if (lhs_ones && rhs_ones) {
+      std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), out);
+    } else if (!lhs_ones && !rhs_ones) {
+      ans.type = kind::zeros;
+      std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), out);
+    } else if (lhs_ones) {
+      std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), out);
+    } else {
+      std::set_difference(rhs.begin(), rhs.end(), lhs.begin(), lhs.end(), out);
+    }
+    break;
+  case operation::bit_or:
+    if (lhs_ones && rhs_ones) {
+      std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), out);
+    } else if (!lhs_ones && !rhs_ones) {
+      ans.type = kind::zeros;
+      std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), out);
+    } else {
+      ans.type = kind::zeros;
+      if (lhs_ones) {
+        std::set_difference(rhs.begin(), rhs.end(), lhs.begin(), lhs.end(), out);
+      } else {
+        std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), out);
+      }
+    }
+    break;
+  case operation::bit_xor:
+    ans.type = lhs_ones == rhs_ones ? kind::ones : kind::zeros;
+    std::set_symmetric_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), out);
+    break;
+  }
+  cur = std::move(ans);
+  normalize(chunk);
+  return true;
+}
+
+void compressed_bitset::apply_words(operation op, std::size_t chunk, const word_type* other, word_type* buffer) {
+  std::size_t bits = chunk_size(chunk);
+  std::size_t words = words_count(bits);
+  chunks_[chunk].to_words(buffer, bits);
+  switch (op) {
+  case operation::bit_and:
+    kernels::bit_and(buffer, other, words);
+    break;
+  case operation::bit_or:
+    kernels::bit_or(buffer, other, words);
+    break;
+  case operation::bit_xor:
+    kernels::bit_xor(buffer, other, words);
+    break;
+  }
+  chunks_[chunk] = container::from_words(buffer, bits);
+}
+
+compressed_bitset operator&(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset ans = lhs;
+  ans &= rhs;
+  return ans;
+}
+
+compressed_bitset operator|(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset ans = lhs;
+  ans |= rhs;
+  return ans;
+}
+
+compressed_bitset operator^(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset ans = lhs;
+  ans ^= rhs;
+  return ans;
+}
+
+compressed_bitset operator&(const compressed_bitset& lhs, const bitset::const_view& rhs) {
+  compressed_bitset ans = lhs;
+  ans &= rhs;
+  return ans;
+}
+
+void swap(compressed_bitset& lhs, compressed_bitset& rhs) {
+  lhs.swap(rhs);
+}
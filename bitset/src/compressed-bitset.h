@@ -0,0 +1,104 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Roaring-style bitset. Bits are split into chunks of 2^16, each chunk is stored as a sorted array
+// of set positions, a sorted array of cleared positions or a plain bitmap, whichever is the smallest.
+// The representation of a chunk is determined by its contents only.
+class compressed_bitset {
+public:
+  using word_type = bitset::word_type;
+  using const_view = bitset::const_view;
+
+  compressed_bitset() = default;
+  compressed_bitset(std::size_t size, bool value);
+  explicit compressed_bitset(const const_view& vw);
+
+  bitset to_bitset() const;
+
+  std::size_t size() const;
+  bool empty() const;
+
+  // Number of bytes allocated for the chunks.
+  std::size_t memory_usage() const;
+
+  bool test(std::size_t pos) const;
+  void set(std::size_t pos, bool value = true);
+
+  compressed_bitset& set();
+  compressed_bitset& reset();
+  compressed_bitset& flip();
+
+  bool all() const;
+  bool any() const;
+  std::size_t count() const;
+
+  // The operands of the binary operations must have the same size.
+  compressed_bitset& operator&=(const compressed_bitset& other);
+  compressed_bitset& operator|=(const compressed_bitset& other);
+  compressed_bitset& operator^=(const compressed_bitset& other);
+
+  compressed_bitset& operator&=(const const_view& other);
+  compressed_bitset& operator|=(const const_view& other);
+  compressed_bitset& operator^=(const const_view& other);
+
+  void swap(compressed_bitset& other);
+
+  friend bool operator==(const compressed_bitset& lhs, const compressed_bitset& rhs) = default;
+
+private:
+  static constexpr std::size_t chunk_bits = std::size_t(1) << 16;
+  static constexpr std::size_t chunk_words = chunk_bits / constants::word_size_bits;
+  // An array of more positions takes more memory than a bitmap.
+  static constexpr std::size_t array_limit = chunk_words * sizeof(word_type) / sizeof(std::uint16_t);
+
+  enum class operation {
+    bit_and,
+    bit_or,
+    bit_xor,
+  };
+
+  struct container {
+    enum class kind {
+      ones,
+      zeros,
+      bitmap,
+    };
+
+    static kind best_kind(std::size_t count, std::size_t bits);
+    static container from_words(const word_type* data, std::size_t bits);
+    void to_words(word_type* dst, std::size_t bits) const;
+
+    bool test(std::size_t pos) const;
+    std::size_t count(std::size_t bits) const;
+
+    friend bool operator==(const container& lhs, const container& rhs) = default;
+
+    kind type = kind::ones;
+    std::vector<std::uint16_t> positions;
+    std::vector<word_type> words;
+    std::size_t ones = 0;
+  };
+
+  std::size_t chunk_size(std::size_t chunk) const;
+  void normalize(std::size_t chunk);
+
+  compressed_bitset& apply(operation op, const compressed_bitset& other);
+  compressed_bitset& apply(operation op, const const_view& other);
+  bool apply_arrays(operation op, std::size_t chunk, const container& other);
+  void apply_words(operation op, std::size_t chunk, const word_type* other, word_type* buffer);
+
+  std::size_t size_ = 0;
+  std::vector<container> chunks_;
+};
+
+compressed_bitset operator&(const compressed_bitset& lhs, const compressed_bitset& rhs);
+compressed_bitset operator|(const compressed_bitset& lhs, const compressed_bitset& rhs);
+compressed_bitset operator^(const compressed_bitset& lhs, const compressed_bitset& rhs);
+compressed_bitset operator&(const compressed_bitset& lhs, const bitset::const_view& rhs);
+
+void swap(compressed_bitset& lhs, compressed_bitset& rhs);
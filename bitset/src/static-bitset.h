@@ -0,0 +1,227 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <string_view>
+
+// Bitset of a size known at compile time. The words are stored inline and every operation is constexpr,
+// so loops over the whole bitset have a constant trip count. The views are the ones of the dynamic bitset,
+// the two interoperate through const_view.
+template <std::size_t N>
+class static_bitset {
+public:
+  using value_type = bool;
+  using word_type = constants::word_type;
+  using reference = bitset_reference<word_type>;
+  using const_reference = bitset_reference<const word_type>;
+  using iterator = bitset_iterator<word_type>;
+  using const_iterator = bitset_iterator<const word_type>;
+  using view = bitset_view<word_type>;
+  using const_view = bitset_view<const word_type>;
+
+  static constexpr std::size_t npos = -1;
+
+  constexpr static_bitset() = default;
+
+  constexpr explicit static_bitset(bool value) {
+    if (value) {
+      set();
+    }
+  }
+
+  // Characters past N are ignored, missing ones are zeros.
+  constexpr explicit static_bitset(std::string_view str) {
+    for (std::size_t ind = 0; ind < std::min(N, str.size()); ++ind) {
+      if (str[ind] == '1') {
+        data_[ind / constants::word_size_bits] |= constants::one << (ind % constants::word_size_bits);
+      }
+    }
+  }
+
+  // Otherwise a string literal would be converted to bool.
+  constexpr explicit static_bitset(const char* str)
+      : static_bitset(std::string_view(str)) {}
+
+  // Bits past N are ignored, missing ones are zeros.
+  constexpr explicit static_bitset(const const_view& other) {
+    std::size_t count = std::min(N, other.size());
+    subview(0, count) |= other.subview(0, count);
+  }
+
+  static constexpr std::size_t size() {
+    return N;
+  }
+
+  static constexpr bool empty() {
+    return N == 0;
+  }
+
+  constexpr reference operator[](std::size_t index) {
+    return begin()[static_cast<std::ptrdiff_t>(index)];
+  }
+
+  constexpr const_reference operator[](std::size_t index) const {
+    return begin()[static_cast<std::ptrdiff_t>(index)];
+  }
+
+  constexpr iterator begin() {
+    return {data_.data(), 0};
+  }
+
+  constexpr const_iterator begin() const {
+    return {data_.data(), 0};
+  }
+
+  constexpr iterator end() {
+    return {data_.data(), N};
+  }
+
+  constexpr const_iterator end() const {
+    return {data_.data(), N};
+  }
+
+  constexpr const word_type* data() const {
+    return data_.data();
+  }
+
+  constexpr word_type* data() {
+    return data_.data();
+  }
+
+  constexpr static_bitset& operator&=(const static_bitset& other) {
+    for (std::size_t ind = 0; ind < words; ++ind) {
+      data_[ind] &= other.data_[ind];
+    }
+    return *this;
+  }
+
+  constexpr static_bitset& operator|=(const static_bitset& other) {
+    for (std::size_t ind = 0; ind < words; ++ind) {
+      data_[ind] |= other.data_[ind];
+    }
+    return *this;
+  }
+
+  constexpr static_bitset& operator^=(const static_bitset& other) {
+    for (std::size_t ind = 0; ind < words; ++ind) {
+      data_[ind] ^= other.data_[ind];
+    }
+    return *this;
+  }
+
+  constexpr static_bitset& operator&=(const const_view& other) {
+    subview() &= other;
+    return *this;
+  }
+
+  constexpr static_bitset& operator|=(const const_view& other) {
+    subview() |= other;
+    return *this;
+  }
+
+  constexpr static_bitset& operator^=(const const_view& other) {
+    subview() ^= other;
+    return *this;
+  }
+
+  constexpr static_bitset& flip() {
+    for (std::size_t ind = 0; ind < words; ++ind) {
+      data_[ind] = ~data_[ind];
+    }
+    clear_tail();
+    return *this;
+  }
+
+  constexpr static_bitset& set() {
+    data_.fill(constants::max);
+    clear_tail();
+    return *this;
+  }
+
+  constexpr static_bitset& reset() {
+    data_.fill(0);
+    return *this;
+  }
+
+  constexpr bool all() const {
+    static_bitset full(true);
+    return *this == full;
+  }
+
+  constexpr bool any() const {
+    return std::any_of(data_.begin(), data_.end(), [](word_type value) { return value != 0; });
+  }
+
+  constexpr std::size_t count() const {
+    std::size_t ans = 0;
+    for (std::size_t ind = 0; ind < words; ++ind) {
+      ans += static_cast<std::size_t>(std::popcount(data_[ind]));
+    }
+    return ans;
+  }
+
+  constexpr std::size_t find_first() const {
+    return subview().find_first();
+  }
+
+  constexpr std::size_t find_next(std::size_t pos) const {
+    return subview().find_next(pos);
+  }
+
+  constexpr std::size_t find_last() const {
+    return subview().find_last();
+  }
+
+  constexpr std::size_t find_prev(std::size_t pos) const {
+    return subview().find_prev(pos);
+  }
+
+  constexpr operator const_view() const {
+    return {begin(), end()};
+  }
+
+  constexpr operator view() {
+    return {begin(), end()};
+  }
+
+  constexpr view subview(std::size_t offset = 0, std::size_t count = npos) {
+    return view(begin(), end()).subview(offset, count);
+  }
+
+  constexpr const_view subview(std::size_t offset = 0, std::size_t count = npos) const {
+    return const_view(begin(), end()).subview(offset, count);
+  }
+
+  friend constexpr bool operator==(const static_bitset& lhs, const static_bitset& rhs) = default;
+
+  friend constexpr static_bitset operator&(static_bitset lhs, const static_bitset& rhs) {
+    return lhs &= rhs;
+  }
+
+  friend constexpr static_bitset operator|(static_bitset lhs, const static_bitset& rhs) {
+    return lhs |= rhs;
+  }
+
+  friend constexpr static_bitset operator^(static_bitset lhs, const static_bitset& rhs) {
+    return lhs ^= rhs;
+  }
+
+  friend constexpr static_bitset operator~(static_bitset bs) {
+    return bs.flip();
+  }
+
+private:
+  static constexpr std::size_t words = (N + constants::word_size_bits - 1) / constants::word_size_bits;
+
+  constexpr void clear_tail() {
+    if constexpr (N % constants::word_size_bits != 0) {
+      data_[words - 1] &= constants::max >> (constants::word_size_bits - N % constants::word_size_bits);
+    }
+  }
+
+  std::array<word_type, words> data_{};
+};
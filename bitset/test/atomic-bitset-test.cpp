@@ -0,0 +1,97 @@
+#include "atomic-bitset.h"
+
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST_CASE("atomic bitset single bits") {
+  atomic_bitset bs(100, false);
+  CHECK(bs.size() == 100);
+  CHECK_FALSE(bs.any());
+
+  bs.set(3);
+  bs[70] = true;
+  bs.flip(99);
+  CHECK(bs.test(3));
+  CHECK(bs[70]);
+  CHECK(std::as_const(bs)[99]);
+  CHECK(bs.count() == 3);
+
+  CHECK(bs.test_and_set(3));
+  CHECK_FALSE(bs.test_and_set(4));
+  CHECK(bs.test_and_reset(4));
+  CHECK_FALSE(bs.test_and_reset(4));
+
+  bs[3].flip();
+  bs.reset(70);
+  bs[99] = bs[0];
+  CHECK_FALSE(bs.any());
+}
+
+TEST_CASE("atomic bitset bulk operations") {
+  std::string_view str = "1101000100110100010011010001001101000100110100010011010001001101000100110100010";
+  const bitset source(str);
+  atomic_bitset bs(source);
+  CHECK_THAT(bs.to_bitset(), bitset_equals_string(str));
+
+  const bitset other(source.subview(1) << 1);
+  bs &= other;
+  CHECK(bs.to_bitset() == (source & other));
+  bs |= source;
+  CHECK(bs.to_bitset() == source);
+  bs ^= other;
+  CHECK(bs.to_bitset() == (source ^ other));
+
+  bs.flip();
+  CHECK(bs.to_bitset() == ~(source ^ other));
+  bs.set();
+  CHECK(bs.all());
+  CHECK(bs.count() == str.size());
+  bs.reset();
+  CHECK_FALSE(bs.any());
+}
+
+TEST_CASE("atomic bitset concurrent writers") {
+  const std::size_t size = 100'000;
+  const std::size_t threads = 4;
+  atomic_bitset bs(size, false);
+  std::atomic<std::size_t> first_marks = 0;
+
+  std::vector<std::thread> workers;
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    workers.emplace_back([&, thread] {
+      for (std::size_t i = thread; i < size; i += threads) {
+        bs[i] = true;
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  CHECK(bs.all());
+
+  bs.reset();
+  workers.clear();
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    workers.emplace_back([&] {
+      for (std::size_t i = 0; i < size; ++i) {
+        if (!bs.test_and_set(i)) {
+          ++first_marks;
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  CHECK(first_marks == size);
+  CHECK(bs.count() == size);
+}
@@ -6,9 +6,14 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 
+#include <array>
+#include <cstddef>
+#include <memory_resource>
 #include <random>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 TEST_CASE("bitset default constructor") {
   bitset bs;
@@ -108,6 +113,180 @@ TEST_CASE("bitset copy constructor") {
   }
 }
 
+TEST_CASE("bitset swap") {
+  std::size_t size_1 = GENERATE(7, 300);
+  std::size_t size_2 = GENERATE(0, 7, 300);
+  CAPTURE(size_1, size_2);
+
+  std::string str_1(size_1, '0');
+  std::string str_2(size_2, '1');
+  for (std::size_t i = 0; i < str_1.size(); i += 3) {
+    str_1[i] = '1';
+  }
+
+  bitset bs_1(str_1);
+  bitset bs_2(str_2);
+
+  swap(bs_1, bs_2);
+  CHECK_THAT(bs_1, bitset_equals_string(str_2));
+  CHECK_THAT(bs_2, bitset_equals_string(str_1));
+
+  bs_1 = bs_2;
+  CHECK_THAT(bs_1, bitset_equals_string(str_1));
+}
+
+TEST_CASE("bitset move") {
+  std::size_t size = GENERATE(0, 7, 300);
+  CAPTURE(size);
+
+  std::string str(size, '0');
+  for (std::size_t i = 0; i < str.size(); i += 3) {
+    str[i] = '1';
+  }
+
+  bitset bs(str);
+  const bitset::word_type* data = bs.data();
+  bitset moved = std::move(bs);
+  CHECK_THAT(moved, bitset_equals_string(str));
+  if (size > 128) {
+    CHECK(moved.data() == data);
+  }
+
+  bitset other(5, true);
+  other = std::move(moved);
+  CHECK_THAT(other, bitset_equals_string(str));
+
+  std::array<std::byte, 1024> buffer{};
+  std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size());
+  bitset local(&resource);
+  local = std::move(other);
+  CHECK(local.get_allocator().resource() == &resource);
+  CHECK_THAT(local, bitset_equals_string(str));
+}
+
+TEST_CASE("bitset push_back and append") {
+  std::string str;
+  bitset bs;
+  std::mt19937 rng(42);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    bool value = rng() % 2 == 0;
+    bs.push_back(value);
+    str += value ? '1' : '0';
+  }
+  CHECK(bs.capacity() >= bs.size());
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs.append(bitset("1101"));
+  str += "1101";
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs.append(bs.subview(3, 500));
+  str += str.substr(3, 500);
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs.append(bs);
+  str += str;
+  CHECK_THAT(bs, bitset_equals_string(str));
+}
+
+TEST_CASE("bitset resize") {
+  bitset bs("1101101");
+  bs.resize(100, true);
+  std::string str = "1101101" + std::string(93, '1');
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs.resize(70);
+  str.resize(70);
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs.resize(200);
+  str.resize(200, '0');
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs.resize(3);
+  bs.resize(130, false);
+  CHECK_THAT(bs, bitset_equals_string("110" + std::string(127, '0')));
+}
+
+TEST_CASE("bitset reserve and shrink_to_fit") {
+  bitset bs("1101101");
+  bs.reserve(1000);
+  CHECK(bs.capacity() >= 1000);
+  const bitset::word_type* data = bs.data();
+  for (std::size_t i = 7; i < 1000; ++i) {
+    bs.push_back(i % 2 == 1);
+  }
+  CHECK(bs.data() == data);
+  CHECK(bs.count() == 5 + 497);
+
+  bs.resize(300);
+  bs.shrink_to_fit();
+  CHECK(bs.capacity() == 320);
+  CHECK(bs.count() == 5 + 147);
+
+  bs.resize(100);
+  bs.shrink_to_fit();
+  CHECK(bs.capacity() == 128);
+  CHECK(bs.count() == 5 + 47);
+}
+
+TEST_CASE("bitset grows out of inline storage") {
+  std::string str = "1101101";
+  bitset bs(str);
+
+  for (std::size_t shift : {50, 71, 1, 200}) {
+    bs <<= shift;
+    bs[bs.size() - 1] = true;
+    str.append(shift - 1, '0');
+    str += '1';
+    REQUIRE_THAT(bs, bitset_equals_string(str));
+  }
+
+  bs >>= 300;
+  str.erase(str.size() - 300);
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs <<= 60;
+  str.append(60, '0');
+  CHECK_THAT(bs, bitset_equals_string(str));
+}
+
+TEST_CASE("bitset uses the given memory resource") {
+  std::array<std::byte, 4096> buffer{};
+  std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  std::string str(300, '0');
+  str[7] = str[250] = '1';
+
+  bitset bs(str, &resource);
+  CHECK(bs.get_allocator().resource() == &resource);
+  CHECK(bs.data() >= reinterpret_cast<bitset::word_type*>(buffer.data()));
+  CHECK(bs.data() < reinterpret_cast<bitset::word_type*>(buffer.data() + buffer.size()));
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs <<= 200;
+  str.append(200, '0');
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bitset copy(bs);
+  CHECK(copy.get_allocator().resource() == std::pmr::get_default_resource());
+  bs = bitset(10, true);
+  CHECK(bs.get_allocator().resource() == &resource);
+  CHECK_THAT(bs, bitset_equals_string("1111111111"));
+  CHECK_THAT(copy, bitset_equals_string(str));
+}
+
+TEST_CASE("view over external words") {
+  std::vector<bitset::word_type> words = {0b1011, 0, 1};
+  bitset::view vw(words.data(), 129);
+
+  CHECK(vw.count() == 4);
+  CHECK(vw.find_last() == 128);
+  vw.subview(64, 64).set();
+  CHECK(words[1] == ~bitset::word_type(0));
+  CHECK(words[2] == 1);
+  CHECK(bitset(vw).count() == 68);
+}
+
 TEST_CASE("bitset constructor from view") {
   SECTION("empty") {
     const bitset source("1101101");
@@ -160,3 +339,83 @@ TEST_CASE("ostream << bitset") {
   ss << bs;
   CHECK(ss.str() == str);
 }
+
+TEST_CASE("string conversions of long bitsets") {
+  std::mt19937 rng(42);
+  std::string str(1000, '0');
+  for (auto& c : str) {
+    c = (rng() % 2 == 0) ? '0' : '1';
+  }
+  const bitset bs(str);
+  CHECK_THAT(bs, bitset_equals_string(str));
+  CHECK(to_string(bs) == str);
+  CHECK(to_string(bs.subview(3, 900)) == str.substr(3, 900));
+
+  std::stringstream ss;
+  ss << bs.subview(70, 500);
+  CHECK(ss.str() == str.substr(70, 500));
+
+  CHECK_THAT(bitset("10x1 1"), bitset_equals_string("100101"));
+}
+
+TEST_CASE("binary serialization") {
+  std::string str = "1101000100110100010011010001001101000100110100010011010001001101000100110100010";
+  const bitset source(str);
+
+  auto [offset, count] = GENERATE(table<std::size_t, std::size_t>({
+      {0, 0},
+      {0, 79},
+      {5, 64},
+      {13, 50},
+  }));
+  CAPTURE(offset, count);
+
+  std::stringstream ss;
+  write_binary(ss, source.subview(offset, count));
+  CHECK(ss.str().size() == 8 * (1 + (count + 63) / 64));
+
+  bitset bs(3, true);
+  read_binary(ss, bs);
+  CHECK(ss);
+  CHECK_THAT(bs, bitset_equals_string(str.substr(offset, count)));
+}
+
+TEST_CASE("binary deserialization of malformed input") {
+  std::stringstream ss;
+  write_binary(ss, bitset("1011"));
+  std::string data = ss.str();
+
+  bitset bs("01");
+  std::stringstream truncated(data.substr(0, data.size() - 1));
+  read_binary(truncated, bs);
+  CHECK(truncated.fail());
+  CHECK_THAT(bs, bitset_equals_string("01"));
+
+  data.back() = 1;
+  std::stringstream padded(data);
+  read_binary(padded, bs);
+  CHECK(padded.fail());
+  CHECK_THAT(bs, bitset_equals_string("01"));
+}
+
+TEST_CASE("binary deserialization of malformed header") {
+  bitset bs("01");
+
+  SECTION("truncated header") {
+    std::stringstream ss(std::string(3, '\x05'));
+    read_binary(ss, bs);
+    CHECK(ss.fail());
+  }
+  SECTION("all-ones size") {
+    std::stringstream ss(std::string(8, '\xFF') + std::string(16, '\0'));
+    read_binary(ss, bs);
+    CHECK(ss.fail());
+  }
+  SECTION("oversized size") {
+    // 2^60 bits, the stream holds only one word of them.
+    std::stringstream ss(std::string(7, '\0') + '\x10' + std::string(8, '\0'));
+    read_binary(ss, bs);
+    CHECK(ss.fail());
+  }
+  CHECK_THAT(bs, bitset_equals_string("01"));
+}
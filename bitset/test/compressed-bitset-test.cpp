@@ -0,0 +1,122 @@
+#include "compressed-bitset.h"
+
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <random>
+
+namespace {
+bitset make_bitset(std::size_t size, int density, unsigned seed) {
+  std::mt19937 rng(seed);
+  bitset bs(size, false);
+  for (std::size_t i = 0; i < size; ++i) {
+    bs[i] = static_cast<int>(rng() % 100) < density;
+  }
+  return bs;
+}
+} // namespace
+
+TEST_CASE("compressed bitset default constructor") {
+  compressed_bitset bs;
+
+  CHECK(bs.empty());
+  CHECK(bs.count() == 0);
+  CHECK(bs.all());
+  CHECK_FALSE(bs.any());
+  CHECK(bs.to_bitset().empty());
+}
+
+TEST_CASE("compressed bitset filled constructor") {
+  std::size_t size = GENERATE(1, 100, 65536, 200000);
+  CAPTURE(size);
+
+  compressed_bitset ones(size, true);
+  CHECK(ones.count() == size);
+  CHECK(ones.all());
+  CHECK(ones.to_bitset() == bitset(size, true));
+  CHECK(ones.memory_usage() < 1024);
+
+  compressed_bitset zeros(size, false);
+  CHECK_FALSE(zeros.any());
+  CHECK(zeros.to_bitset() == bitset(size, false));
+}
+
+TEST_CASE("compressed bitset round trip") {
+  std::size_t size = GENERATE(5, 65537, 150000);
+  int density = GENERATE(0, 1, 50, 99, 100);
+  CAPTURE(size, density);
+
+  bitset bs = make_bitset(size, density, 1);
+  compressed_bitset compressed(bs);
+  CHECK(compressed.size() == size);
+  CHECK(compressed.count() == bs.count());
+  CHECK(compressed.all() == bs.all());
+  CHECK(compressed.any() == bs.any());
+  CHECK(compressed.to_bitset() == bs);
+
+  compressed_bitset from_view(bs.subview(3));
+  CHECK(from_view.to_bitset() == bs.subview(3));
+}
+
+TEST_CASE("compressed bitset single bits") {
+  compressed_bitset bs(200000, false);
+  bitset expected(200000, false);
+  std::mt19937 rng(2);
+  for (int i = 0; i < 20000; ++i) {
+    std::size_t pos = rng() % 70000;
+    bool value = rng() % 8 != 0;
+    bs.set(pos, value);
+    expected[pos] = value;
+  }
+  for (std::size_t i = 0; i < expected.size(); i += 7) {
+    REQUIRE(bs.test(i) == expected[i]);
+  }
+  CHECK(bs.to_bitset() == expected);
+  CHECK(bs == compressed_bitset(expected));
+}
+
+TEST_CASE("compressed bitset operations") {
+  std::size_t size = GENERATE(1000, 140000);
+  int density_1 = GENERATE(1, 50, 99);
+  int density_2 = GENERATE(1, 50, 99);
+  CAPTURE(size, density_1, density_2);
+
+  bitset lhs = make_bitset(size, density_1, 3);
+  bitset rhs = make_bitset(size, density_2, 4);
+  compressed_bitset compressed_lhs(lhs);
+  compressed_bitset compressed_rhs(rhs);
+
+  SECTION("with compressed") {
+    CHECK((compressed_lhs & compressed_rhs).to_bitset() == (lhs & rhs));
+    CHECK((compressed_lhs | compressed_rhs).to_bitset() == (lhs | rhs));
+    CHECK((compressed_lhs ^ compressed_rhs).to_bitset() == (lhs ^ rhs));
+  }
+
+  SECTION("with dense") {
+    CHECK((compressed_lhs & rhs).to_bitset() == (lhs & rhs));
+    compressed_lhs |= rhs;
+    CHECK(compressed_lhs.to_bitset() == (lhs | rhs));
+    compressed_lhs ^= rhs;
+    CHECK(compressed_lhs.to_bitset() == ((lhs | rhs) ^ rhs));
+  }
+
+  SECTION("flip") {
+    compressed_lhs.flip();
+    CHECK(compressed_lhs.to_bitset() == ~lhs);
+    CHECK(compressed_lhs.count() == size - lhs.count());
+  }
+}
+
+TEST_CASE("compressed bitset memory usage") {
+  bitset sparse = make_bitset(1 << 20, 1, 5);
+  bitset dense = make_bitset(1 << 20, 99, 6);
+  bitset random = make_bitset(1 << 20, 50, 7);
+
+  std::size_t dense_bytes = (1 << 20) / 8;
+  CHECK(compressed_bitset(sparse).memory_usage() < dense_bytes / 2);
+  CHECK(compressed_bitset(dense).memory_usage() < dense_bytes / 2);
+  CHECK(compressed_bitset(random).memory_usage() < dense_bytes * 11 / 10);
+}
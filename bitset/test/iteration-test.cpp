@@ -6,7 +6,9 @@
 #include <catch2/matchers/catch_matchers_range_equals.hpp>
 
 #include <ranges>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 TEST_CASE("bitset forward iteration") {
   SECTION("empty") {
@@ -128,3 +130,44 @@ TEST_CASE("empty subviews are equal") {
   const bitset bs_2("110101");
   CHECK(bs_1.subview(0, 0) == bs_2.subview(bs_2.size(), 0));
 }
+
+TEST_CASE("find set bits") {
+  std::string_view str = "00000100000000000000000000000000000000000000000000000000000000000000001000001100";
+  std::size_t offset = GENERATE(0, 3);
+  CAPTURE(offset);
+
+  std::vector<std::size_t> expected;
+  for (std::size_t i = offset; i < str.size(); ++i) {
+    if (str[i] == '1') {
+      expected.push_back(i - offset);
+    }
+  }
+
+  const bitset bs(str);
+  bitset::const_view vw = bs.subview(offset);
+
+  CHECK(vw.find_first() == expected.front());
+  CHECK(vw.find_last() == expected.back());
+  CHECK(vw.find_next(expected[0]) == expected[1]);
+  CHECK(vw.find_next(expected[1] - 1) == expected[1]);
+  CHECK(vw.find_next(expected.back()) == bitset::npos);
+  CHECK(vw.find_prev(expected[1]) == expected[0]);
+  CHECK(vw.find_prev(expected[0]) == bitset::npos);
+  CHECK(vw.find_prev(bitset::npos) == expected.back());
+
+  std::vector<std::size_t> actual;
+  for (std::size_t pos : vw.set_bits()) {
+    actual.push_back(pos);
+  }
+  CHECK(actual == expected);
+}
+
+TEST_CASE("find in empty bitset") {
+  const bitset bs(100, false);
+
+  CHECK(bs.find_first() == bitset::npos);
+  CHECK(bs.find_last() == bitset::npos);
+  CHECK(bs.find_next(0) == bitset::npos);
+  CHECK(bs.find_prev(100) == bitset::npos);
+  CHECK(bs.set_bits().begin() == bs.set_bits().end());
+}
@@ -7,6 +7,8 @@
 
 #include <algorithm>
 #include <array>
+#include <random>
+#include <string>
 #include <utility>
 
 TEST_CASE("left shift") {
@@ -107,6 +109,48 @@ TEST_CASE("right shift") {
   }
 }
 
+TEST_CASE("shift after right shift") {
+  std::string str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101";
+  bitset bs(str);
+
+  bs >>= 10;
+  bs <<= 3;
+
+  str.erase(str.size() - 10);
+  str.append(3, '0');
+  CHECK_THAT(bs, bitset_equals_string(str));
+  CHECK(bs.count() == static_cast<std::size_t>(std::ranges::count(str, '1')));
+}
+
+TEST_CASE("view shifts") {
+  std::string str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101";
+  std::size_t offset = GENERATE(0, 3);
+  std::size_t count = GENERATE(7, 70);
+  std::size_t shift_count = GENERATE(0, 1, 5, 64, 190);
+  CAPTURE(offset, count, shift_count);
+
+  std::string part = str.substr(offset, count);
+  std::string zeros(std::min(shift_count, count), '0');
+
+  SECTION("left") {
+    bitset bs(str);
+    bs.subview(offset, count) <<= shift_count;
+
+    std::string expected = str;
+    expected.replace(offset, count, part.substr(zeros.size()) + zeros);
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+
+  SECTION("right") {
+    bitset bs(str);
+    bs.subview(offset, count) >>= shift_count;
+
+    std::string expected = str;
+    expected.replace(offset, count, zeros + part.substr(0, count - zeros.size()));
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+}
+
 TEST_CASE("bitwise operations") {
   SECTION("empty") {
     bitset bs;
@@ -412,3 +456,199 @@ TEST_CASE("chained view operations") {
   CHECK(bs_1 == bitset("0010000001"));
   CHECK(bs_2 == bitset("1110010101"));
 }
+
+TEST_CASE("view operations on equally aligned ranges") {
+  std::string str_1 =
+      "1111011011101000010010111110100001101111111100000110011001001000101110010011010111110110111010000100101111101000"
+      "0110111111110000011001100100100010111001001101011111011011101000";
+  std::string str_2 =
+      "0110100111010101000011110000101101101110101001000110011001001111101110010011010111010110111010000100101111101000"
+      "1110111111110000011001100100100010111001000001011111011000001000";
+  REQUIRE(str_1.size() == str_2.size());
+
+  std::size_t offset = GENERATE(0, 3, 64);
+  std::size_t count = GENERATE(0, 5, 61, 64, 110);
+  CAPTURE(offset, count);
+
+  bitset bs_1(str_1);
+  const bitset bs_2(str_2);
+  bitset::view vw_1 = bs_1.subview(offset, count);
+  bitset::const_view vw_2 = bs_2.subview(offset, count);
+
+  CHECK((vw_1 == vw_2) == (str_1.substr(offset, count) == str_2.substr(offset, count)));
+
+  std::string expected = str_1;
+  for (std::size_t i = offset; i < offset + count; ++i) {
+    expected[i] = (str_1[i] != str_2[i]) ? '1' : '0';
+  }
+  vw_1 ^= vw_2;
+  CHECK_THAT(bs_1, bitset_equals_string(expected));
+  CHECK(vw_1.count() == static_cast<std::size_t>(std::ranges::count(expected.substr(offset, count), '1')));
+
+  vw_1.set();
+  CHECK(vw_1.all());
+  vw_1.reset();
+  CHECK_FALSE(vw_1.any());
+}
+
+TEST_CASE("operations on long bitsets") {
+  std::size_t size = GENERATE(511, 512, 1000, 1029);
+  CAPTURE(size);
+
+  std::mt19937 rng(static_cast<unsigned>(size));
+  std::string str_1(size, '0');
+  std::string str_2(size, '0');
+  for (std::size_t i = 0; i < size; ++i) {
+    str_1[i] = (rng() % 2 == 0) ? '1' : '0';
+    str_2[i] = (rng() % 2 == 0) ? '1' : '0';
+  }
+
+  bitset bs_1(str_1);
+  const bitset bs_2(str_2);
+
+  CHECK(bs_1.count() == static_cast<std::size_t>(std::ranges::count(str_1, '1')));
+  CHECK(bs_1 != bs_2);
+  CHECK(bs_1 == bitset(str_1));
+
+  std::string expected = str_1;
+  for (std::size_t i = 0; i < size; ++i) {
+    expected[i] = (str_1[i] == '1' || str_2[i] == '1') ? '1' : '0';
+  }
+  bs_1 |= bs_2;
+  CHECK_THAT(bs_1, bitset_equals_string(expected));
+
+  for (std::size_t i = 0; i < size; ++i) {
+    expected[i] = (expected[i] == '1' && str_2[i] == '1') ? '1' : '0';
+  }
+  bs_1 &= bs_2;
+  CHECK_THAT(bs_1, bitset_equals_string(expected));
+  CHECK(bs_1 == bs_2);
+
+  bs_1 ^= bs_2;
+  CHECK_FALSE(bs_1.any());
+  bs_1.flip();
+  CHECK(bs_1.all());
+  CHECK(bs_1.count() == size);
+}
+
+TEST_CASE("chained expressions") {
+  std::size_t size = GENERATE(0, 7, 64, 200);
+  std::size_t offset = GENERATE(0, 3);
+  CAPTURE(size, offset);
+
+  std::mt19937 rng(static_cast<unsigned>(size + offset));
+  std::array<std::string, 3> strs;
+  for (auto& str : strs) {
+    str.resize(size + offset);
+    for (auto& c : str) {
+      c = (rng() % 2 == 0) ? '1' : '0';
+    }
+  }
+  const bitset a(strs[0]);
+  const bitset b(strs[1]);
+  const bitset c(strs[2]);
+  auto va = a.subview(offset);
+  auto vb = b.subview(offset);
+  auto vc = c.subview(offset);
+
+  std::string expected(size, '0');
+  for (std::size_t i = 0; i < size; ++i) {
+    bool bit = (strs[0][i + offset] == '1' && strs[1][i + offset] == '1') || strs[2][i + offset] == '0';
+    expected[i] = bit ? '1' : '0';
+  }
+
+  bitset result = (va & vb) | ~vc;
+  CHECK_THAT(result, bitset_equals_string(expected));
+  CHECK(((va & vb) | ~vc).count() == static_cast<std::size_t>(std::ranges::count(expected, '1')));
+  CHECK(((va & vb) | ~vc).any() == result.any());
+  CHECK(((va & vb) | ~vc).all() == result.all());
+  CHECK(((va & vb) | ~vc) == result);
+  CHECK(result == ((va & vb) | ~vc));
+  CHECK(to_string((va & vb) | ~vc) == expected);
+
+  CHECK_THAT(bitset((result << 70) >> 70), bitset_equals_string(expected));
+  CHECK(~~va == va);
+  CHECK(((va ^ vb) ^ vb) == va);
+}
+
+TEST_CASE("assignment from expression") {
+  bitset bs_1("1100");
+  bitset bs_2("1010");
+
+  bs_1 = bs_1 ^ bs_2;
+  CHECK_THAT(bs_1, bitset_equals_string("0110"));
+
+  bs_1 = (bs_1 << 2) | (bs_2 << 2);
+  CHECK_THAT(bs_1, bitset_equals_string("111000"));
+
+  bs_2 = ~bs_1 >> 3;
+  CHECK_THAT(bs_2, bitset_equals_string("000"));
+}
+
+TEST_CASE("expressions over several chunks") {
+  std::size_t size = GENERATE(20'000, 40'001);
+  std::size_t offset = GENERATE(0, 3);
+  CAPTURE(size, offset);
+
+  std::mt19937 rng(static_cast<unsigned>(size + offset));
+  std::array<bitset, 3> bits;
+  for (auto& bs : bits) {
+    bs = bitset(size + offset, false);
+    for (std::size_t i = 0; i < size + offset; ++i) {
+      bs[i] = rng() % 2 == 0;
+    }
+  }
+  auto va = bits[0].subview(offset);
+  auto vb = bits[1].subview(offset);
+  auto vc = bits[2].subview(offset);
+
+  bitset expected(vc);
+  expected.flip();
+  bitset both(va);
+  both &= vb;
+  expected |= both;
+
+  bitset result = (va & vb) | ~vc;
+  CHECK(result == expected);
+  CHECK(((va & vb) | ~vc).count() == expected.count());
+  CHECK(((va & vb) | ~vc).any());
+  CHECK_FALSE(((va & vb) | ~vc).all());
+  CHECK((va | ~va).all());
+  CHECK_FALSE((va & ~va).any());
+  CHECK(bitset((result << 100) >> 100) == expected);
+}
+
+TEST_CASE("expressions in place of bitsets") {
+  bitset a("1100");
+  const bitset b("1010");
+  const bitset c("0110");
+
+  SECTION("compound assignment") {
+    a &= b | c;
+    CHECK_THAT(a, bitset_equals_string("1100"));
+    a ^= b & c;
+    CHECK_THAT(a, bitset_equals_string("1110"));
+    a |= ~b;
+    CHECK_THAT(a, bitset_equals_string("1111"));
+    a.subview(1) &= b.subview(1) ^ c.subview(1);
+    CHECK_THAT(a, bitset_equals_string("1100"));
+  }
+
+  SECTION("view parameter") {
+    auto text = [](const bitset::const_view& vw) { return to_string(vw); };
+    CHECK(text(a & b) == "1000");
+    CHECK(text(~a) == "0011");
+    CHECK(to_string((a | b).subview(1, 2)) == "11");
+    CHECK(std::count((a ^ b).begin(), (a ^ b).end(), true) == 2);
+  }
+
+  SECTION("temporary operand") {
+    auto make = [] { return bitset("0110"); };
+    bitset d = make() & a;
+    CHECK_THAT(d, bitset_equals_string("0100"));
+    auto e = make() ^ bitset("1111");
+    CHECK_THAT(bitset(e), bitset_equals_string("1001"));
+    auto f = ~make() | a;
+    CHECK(f == bitset("1101"));
+  }
+}
@@ -0,0 +1,80 @@
+#include "bitset-parallel.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <random>
+
+namespace {
+bitset random_bitset(std::size_t size, unsigned seed) {
+  std::mt19937 rng(seed);
+  bitset bs(size, false);
+  for (std::size_t i = 0; i < size; i += 1 + rng() % 7) {
+    bs[i] = true;
+  }
+  return bs;
+}
+} // namespace
+
+TEST_CASE("parallel operations match sequential ones") {
+  std::size_t threads = GENERATE(1, 3, 8);
+  std::size_t offset = GENERATE(0, 1, 100);
+  CAPTURE(threads, offset);
+
+  const std::size_t size = 5'000'000;
+  bitset_parallel executor(threads);
+  CHECK(executor.threads() == threads);
+
+  bitset lhs = random_bitset(size + offset, 1);
+  const bitset rhs = random_bitset(size + 2 * offset, 2);
+  bitset::view dst = lhs.subview(offset);
+  bitset::const_view src = rhs.subview(2 * offset);
+
+  bitset expected(dst);
+  CHECK(executor.count(dst) == expected.count());
+  CHECK(executor.equal(dst, expected));
+  CHECK_FALSE(executor.all(dst));
+  CHECK(executor.any(dst));
+
+  expected &= src;
+  executor.bit_and(dst, src);
+  CHECK(dst == expected);
+
+  expected |= src;
+  executor.bit_or(dst, src);
+  CHECK(dst == expected);
+
+  expected ^= src;
+  executor.bit_xor(dst, src);
+  CHECK(dst == expected);
+
+  expected.flip();
+  executor.flip(dst);
+  CHECK(dst == expected);
+  CHECK(executor.count(dst) == expected.count());
+
+  CHECK(lhs.subview(0, offset) == random_bitset(size + offset, 1).subview(0, offset));
+
+  dst.reset();
+  CHECK_FALSE(executor.any(dst));
+  dst.set();
+  CHECK(executor.all(dst));
+  dst[size / 2] = false;
+  CHECK_FALSE(executor.all(dst));
+  CHECK_FALSE(executor.equal(dst, bitset(size, true)));
+}
+
+TEST_CASE("parallel operations on short views") {
+  bitset_parallel executor(4);
+  bitset bs("1101");
+
+  CHECK(executor.count(bs) == 3);
+  executor.flip(bs);
+  CHECK(bs == bitset("0010"));
+  CHECK(executor.equal(bs.subview(2), bitset("10")));
+  CHECK_FALSE(executor.equal(bs, bitset("001")));
+  CHECK(executor.all(bitset()));
+  CHECK_FALSE(executor.any(bitset()));
+}
@@ -0,0 +1,95 @@
+#include "bitset-rank-select.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST_CASE("rank/select on empty view") {
+  const bitset bs;
+  bitset_rank_select index(bs);
+
+  CHECK(index.rank1(0) == 0);
+  CHECK(index.rank0(0) == 0);
+  CHECK(index.select1(0) == bitset_rank_select::npos);
+}
+
+TEST_CASE("rank/select match naive counting") {
+  std::size_t size = GENERATE(1, 63, 512, 4000, 70000);
+  std::size_t offset = GENERATE(0, 5);
+  CAPTURE(size, offset);
+
+  std::mt19937 rng(static_cast<unsigned>(size));
+  bitset bs(size + offset, false);
+  for (std::size_t i = 0; i < bs.size(); ++i) {
+    bs[i] = (rng() % 3 == 0);
+  }
+
+  bitset::const_view vw = std::as_const(bs).subview(offset);
+  bitset_rank_select index(vw);
+
+  std::vector<std::size_t> ones;
+  for (std::size_t i = 0; i < vw.size(); ++i) {
+    if (vw[i]) {
+      ones.push_back(i);
+    }
+  }
+
+  for (std::size_t pos = 0; pos <= vw.size(); pos += 1 + pos / 7) {
+    CAPTURE(pos);
+    REQUIRE(index.rank1(pos) == vw.subview(0, pos).count());
+    REQUIRE(index.rank0(pos) == pos - vw.subview(0, pos).count());
+  }
+  for (std::size_t rank = 0; rank < ones.size(); rank += 1 + rank / 7) {
+    CAPTURE(rank);
+    REQUIRE(index.select1(rank) == ones[rank]);
+  }
+  CHECK(index.select1(ones.size()) == bitset_rank_select::npos);
+}
+
+TEST_CASE("rank/select after invalidate") {
+  bitset bs(1000, false);
+  bitset_rank_select index(bs);
+
+  CHECK(index.rank1(1000) == 0);
+
+  bs[10] = true;
+  bs[700] = true;
+  index.invalidate();
+
+  CHECK(index.rank1(1000) == 2);
+  CHECK(index.rank1(11) == 1);
+  CHECK(index.select1(1) == 700);
+}
+
+TEST_CASE("rank/select queried from many threads") {
+  const std::size_t size = 100'000;
+  const std::size_t threads = 4;
+  bitset bs(size, false);
+  for (std::size_t i = 0; i < size; i += 3) {
+    bs[i] = true;
+  }
+  const bitset_rank_select index(bs);
+  std::atomic<std::size_t> mismatches = 0;
+
+  std::vector<std::thread> workers;
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    workers.emplace_back([&, thread] {
+      for (std::size_t i = thread; i < size / 3; i += threads) {
+        if (index.rank1(3 * i) != i || index.select1(i) != 3 * i) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  CHECK(mismatches == 0);
+}
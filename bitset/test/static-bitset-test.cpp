@@ -0,0 +1,66 @@
+#include "static-bitset.h"
+
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace {
+constexpr static_bitset<200> make_mask() {
+  static_bitset<200> bs("1011");
+  bs[150] = true;
+  bs.subview(10, 100).set();
+  bs.subview(60, 8).flip();
+  return bs;
+}
+
+constexpr std::size_t shifted_count() {
+  static_bitset<130> bs(true);
+  bs.subview(3) >>= 70;
+  return bs.count();
+}
+} // namespace
+
+TEST_CASE("static bitset in constant expressions") {
+  constexpr static_bitset<200> bs = make_mask();
+
+  STATIC_CHECK(bs.size() == 200);
+  STATIC_CHECK(bs.count() == 3 + 100 - 8 + 1);
+  STATIC_CHECK(bs[0] && !bs[1] && bs[150]);
+  STATIC_CHECK(bs.find_first() == 0);
+  STATIC_CHECK(bs.find_next(3) == 10);
+  STATIC_CHECK(bs.find_last() == 150);
+  STATIC_CHECK(bs.subview(10, 50).all());
+  STATIC_CHECK_FALSE(bs.subview(60, 8).any());
+  STATIC_CHECK((bs & ~bs).count() == 0);
+  STATIC_CHECK((bs | ~bs).all());
+  STATIC_CHECK((bs ^ bs) == static_bitset<200>());
+  STATIC_CHECK(bs.subview(10, 50) == static_bitset<50>(true));
+  STATIC_CHECK(shifted_count() == 130 - 70);
+  STATIC_CHECK(static_bitset<0>().all());
+}
+
+TEST_CASE("static bitset with dynamic bitset") {
+  std::string str = "110100010011010001001101000100110100010011010001001101000100110100010011010001001";
+  const bitset dynamic(str);
+
+  static_bitset<70> bs(dynamic);
+  CHECK_THAT(bitset(bs), bitset_equals_string(str.substr(0, 70)));
+  CHECK(to_string(bs) == str.substr(0, 70));
+
+  bs ^= dynamic.subview(5, 70);
+  bitset expected(dynamic.subview(0, 70));
+  expected ^= dynamic.subview(5, 70);
+  CHECK(bitset(bs) == expected);
+
+  bitset copy(str.size(), false);
+  copy.subview(11, 70) |= bs;
+  CHECK(copy.subview(11, 70) == bs);
+  CHECK(copy.count() == bs.count());
+
+  static_bitset<100> wide(str);
+  CHECK(to_string(wide) == str + std::string(100 - str.size(), '0'));
+  CHECK(static_bitset<100>(bitset("101")).count() == 2);
+}
@@ -2,7 +2,9 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <functional>
 #include <type_traits>
+#include <utility>
 
 TEST_CASE("member types") {
   SECTION("bitset") {
@@ -42,3 +44,33 @@ TEST_CASE("member types") {
     STATIC_CHECK(std::is_same_v<bitset::const_view::const_reference, bitset::const_reference>);
   }
 }
+
+TEST_CASE("expression types") {
+  bitset a("1010");
+  const bitset b("0110");
+
+  SECTION("auto holds an expression") {
+    auto expr = a & b;
+    STATIC_CHECK(std::is_same_v<
+                 decltype(expr),
+                 bitset_binary_expression<std::bit_and<>, bitset_operand, bitset_operand>>);
+    STATIC_CHECK(std::is_same_v<decltype(~(a ^ b)), bitset_not_expression<decltype(a ^ b)>>);
+    STATIC_CHECK(std::is_same_v<decltype(a << 1), bitset_resize_expression<bitset_operand>>);
+    CHECK(bitset(expr) == bitset("0010"));
+  }
+
+  SECTION("temporary bitsets are owned") {
+    using owned = bitset_owning_operand<bitset>;
+    STATIC_CHECK(std::is_same_v<
+                 decltype(bitset("1") & b),
+                 bitset_binary_expression<std::bit_and<>, owned, bitset_operand>>);
+    STATIC_CHECK(std::is_same_v<decltype(~bitset("1")), bitset_not_expression<owned>>);
+    STATIC_CHECK(std::is_same_v<decltype(std::move(a) << 1), bitset_resize_expression<owned>>);
+    STATIC_CHECK(std::is_same_v<
+                 decltype(b.subview() & a),
+                 bitset_binary_expression<std::bit_and<>, bitset_operand, bitset_operand>>);
+
+    auto expr = bitset("1010") & b;
+    CHECK(bitset(expr) == bitset("0010"));
+  }
+}